@@ -0,0 +1,113 @@
+/*
+ *  Copyright 2026  Sebastian Gottfried <sebastian.gottfried@posteo.de>
+ *
+ *  This program is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU General Public License as
+ *  published by the Free Software Foundation; either version 2 of
+ *  the License, or (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "allocationcounter.h"
+
+#include <atomic>
+
+#ifdef __GLIBC__
+#include <malloc.h>
+
+extern "C"
+{
+    void* __libc_malloc(size_t size);
+    void* __libc_calloc(size_t count, size_t size);
+    void* __libc_realloc(void* ptr, size_t size);
+    void __libc_free(void* ptr);
+}
+#endif
+
+namespace
+{
+    std::atomic<qint64> allocations(0);
+    std::atomic<qint64> bytes(0);
+
+#ifdef __GLIBC__
+    void* countAllocation(void* ptr)
+    {
+        if (ptr)
+        {
+            allocations++;
+            bytes += malloc_usable_size(ptr);
+        }
+
+        return ptr;
+    }
+
+    void countRelease(void* ptr)
+    {
+        if (ptr)
+        {
+            bytes -= malloc_usable_size(ptr);
+        }
+    }
+#endif
+}
+
+#ifdef __GLIBC__
+// these replace the definitions of the C library for the whole process
+
+extern "C" void* malloc(size_t size) __THROW
+{
+    return countAllocation(__libc_malloc(size));
+}
+
+extern "C" void* calloc(size_t count, size_t size) __THROW
+{
+    return countAllocation(__libc_calloc(count, size));
+}
+
+extern "C" void* realloc(void* ptr, size_t size) __THROW
+{
+    countRelease(ptr);
+    void* result = __libc_realloc(ptr, size);
+
+    if (!result && size > 0)
+    {
+        // the old block is still there
+        bytes += malloc_usable_size(ptr);
+        return 0;
+    }
+
+    return countAllocation(result);
+}
+
+extern "C" void free(void* ptr) __THROW
+{
+    countRelease(ptr);
+    __libc_free(ptr);
+}
+#endif
+
+bool AllocationCounter::isAvailable()
+{
+#ifdef __GLIBC__
+    return true;
+#else
+    return false;
+#endif
+}
+
+qint64 AllocationCounter::allocationCount()
+{
+    return allocations;
+}
+
+qint64 AllocationCounter::liveBytes()
+{
+    return bytes;
+}
@@ -0,0 +1,46 @@
+/*
+ *  Copyright 2026  Sebastian Gottfried <sebastian.gottfried@posteo.de>
+ *
+ *  This program is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU General Public License as
+ *  published by the Free Software Foundation; either version 2 of
+ *  the License, or (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef ALLOCATIONCOUNTER_H
+#define ALLOCATIONCOUNTER_H
+
+#include <QtGlobal>
+
+/**
+ * Counts the heap allocations of the whole process by replacing malloc and
+ * friends of the C library. This covers operator new as well as the
+ * containers of Qt, which allocate with malloc directly.
+ *
+ * Only available with glibc, everywhere else isAvailable() returns false.
+ */
+namespace AllocationCounter
+{
+    bool isAvailable();
+
+    /**
+     * Number of calls to malloc, calloc and realloc so far.
+     */
+    qint64 allocationCount();
+
+    /**
+     * Bytes currently allocated on the heap, including the allocator's
+     * rounding of each block.
+     */
+    qint64 liveBytes();
+}
+
+#endif // ALLOCATIONCOUNTER_H
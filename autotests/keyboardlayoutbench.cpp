@@ -0,0 +1,126 @@
+/*
+ *  Copyright 2026  Sebastian Gottfried <sebastian.gottfried@posteo.de>
+ *
+ *  This program is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU General Public License as
+ *  published by the Free Software Foundation; either version 2 of
+ *  the License, or (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <QList>
+#include <QStandardPaths>
+#include <QStringList>
+#include <QVector>
+#include <QtTest>
+
+#include "allocationcounter.h"
+#include "core/dataindex.h"
+#include "core/keyboardlayout.h"
+#include "core/keyboardlayoutdata.h"
+#include "core/resourcedataaccess.h"
+
+/*
+ * Loads all built-in keyboard layouts and reports the heap memory they hold,
+ * once as plain value data and once as QObject trees.
+ */
+
+namespace
+{
+    // returns the heap memory held by the loaded layouts or -1 on failure
+    qint64 loadKeyboardLayouts(const QStringList& paths, bool createObjects)
+    {
+        ResourceDataAccess dataAccess;
+        QVector<KeyboardLayoutData> layoutData;
+        QList<KeyboardLayout*> layouts;
+        layoutData.reserve(paths.count());
+        layouts.reserve(paths.count());
+
+        const qint64 liveBytes = AllocationCounter::liveBytes();
+        bool ok = true;
+
+        foreach (const QString& path, paths)
+        {
+            if (createObjects)
+            {
+                KeyboardLayout* layout = new KeyboardLayout();
+                ok = ok && dataAccess.loadKeyboardLayout(path, layout);
+                layouts.append(layout);
+            }
+            else
+            {
+                KeyboardLayoutData data;
+                ok = ok && dataAccess.loadKeyboardLayoutData(path, &data);
+                layoutData.append(data);
+            }
+        }
+
+        const qint64 bytes = AllocationCounter::liveBytes() - liveBytes;
+        qDeleteAll(layouts);
+        return ok? bytes: -1;
+    }
+}
+
+class KeyboardLayoutBench : public QObject
+{
+    Q_OBJECT
+private slots:
+    void initTestCase();
+    void keyboardLayoutMemory_data();
+    void keyboardLayoutMemory();
+};
+
+void KeyboardLayoutBench::initTestCase()
+{
+    // the built-in resources are looked up like the ones of the application
+    QCoreApplication::setApplicationName(QStringLiteral("ktouch"));
+    QStandardPaths::setTestModeEnabled(true);
+}
+
+void KeyboardLayoutBench::keyboardLayoutMemory_data()
+{
+    QTest::addColumn<bool>("createObjects");
+
+    QTest::newRow("value-data") << false;
+    QTest::newRow("objects") << true;
+}
+
+void KeyboardLayoutBench::keyboardLayoutMemory()
+{
+    QFETCH(bool, createObjects);
+
+    if (!AllocationCounter::isAvailable())
+        QSKIP("allocations can only be counted with glibc");
+
+    ResourceDataAccess dataAccess;
+    DataIndex dataIndex;
+    QVERIFY(dataAccess.fillDataIndex(&dataIndex));
+
+    QStringList paths;
+
+    for (int i = 0; i < dataIndex.keyboardLayoutCount(); i++)
+    {
+        paths.append(dataIndex.keyboardLayout(i)->path());
+    }
+
+    QVERIFY(paths.count() >= 40);
+
+    // the first round fills the caches of the XML schema validation
+    QVERIFY(loadKeyboardLayouts(paths, createObjects) >= 0);
+
+    const qint64 bytes = loadKeyboardLayouts(paths, createObjects);
+    QVERIFY(bytes > 0);
+
+    QTest::setBenchmarkResult(bytes, QTest::BytesAllocated);
+}
+
+QTEST_MAIN(KeyboardLayoutBench)
+
+#include "keyboardlayoutbench.moc"
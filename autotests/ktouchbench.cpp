@@ -0,0 +1,375 @@
+/*
+ *  Copyright 2026  Sebastian Gottfried <sebastian.gottfried@posteo.de>
+ *
+ *  This program is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU General Public License as
+ *  published by the Free Software Foundation; either version 2 of
+ *  the License, or (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <QInputMethodEvent>
+#include <QKeyEvent>
+#include <QRandomGenerator>
+#include <QStandardPaths>
+#include <QTextDocument>
+#include <QVector>
+#include <QtTest>
+
+#include "allocationcounter.h"
+#include "core/lesson.h"
+#include "core/trainingstats.h"
+#include "declarativeitems/lessonpainter.h"
+#include "declarativeitems/traininglinecore.h"
+#include "preferences.h"
+#include "preferencescache.h"
+
+/*
+ * Feeds synthetic keystroke streams through the training pipeline as it is
+ * used on the training screen, without a window. QBENCHMARK reports wall
+ * time by default, run with -tickcounter or -callgrind for CPU ticks or
+ * instruction counts. One iteration is one input event, which carries
+ * several keystrokes for the fast typists.
+ */
+
+namespace
+{
+    const int lessonLineCount = 20;
+    const int lessonLineLength = 60;
+
+    struct SyntheticKey
+    {
+        enum Kind
+        {
+            Text,
+            Backspace,
+            Return,
+            Preedit,
+            Commit
+        };
+
+        Kind kind;
+        QString text;
+    };
+
+    struct Typist
+    {
+        // share of keystrokes which are wrong at first and get corrected
+        // with backspace right away
+        qreal errorRate;
+        // characters delivered in one event, fast typists get several
+        // keystrokes committed at once
+        int charactersPerEvent;
+        // characters are composed in a preedit string first
+        bool composes;
+    };
+
+    QString lessonText()
+    {
+        const QString letters = QStringLiteral("asdfghjkleiruwoqptyzxcvbnm");
+        QRandomGenerator random(23);
+        QStringList lines;
+
+        for (int i = 0; i < lessonLineCount; i++)
+        {
+            QString line;
+
+            while (line.length() < lessonLineLength)
+            {
+                const int wordLength = random.bounded(2, 9);
+
+                for (int j = 0; j < wordLength; j++)
+                {
+                    line += letters.at(random.bounded(letters.length()));
+                }
+
+                line += QLatin1Char(' ');
+            }
+
+            line.truncate(lessonLineLength - 1);
+            line += QLatin1Char('.');
+            lines.append(line);
+        }
+
+        return lines.join(QLatin1Char('\n'));
+    }
+
+    QString wrongCharacter(QChar expected)
+    {
+        return QString(expected == QLatin1Char('x')? QLatin1Char('z'): QLatin1Char('x'));
+    }
+
+    QVector<SyntheticKey> keystrokes(const QString& text, const Typist& typist)
+    {
+        QRandomGenerator random(42);
+        QVector<SyntheticKey> keys;
+
+        foreach (const QString& line, text.split(QLatin1Char('\n')))
+        {
+            for (int i = 0; i < line.length(); i += typist.charactersPerEvent)
+            {
+                const QString characters = line.mid(i, typist.charactersPerEvent);
+
+                if (random.generateDouble() < typist.errorRate)
+                {
+                    keys.append({SyntheticKey::Text, wrongCharacter(line.at(i))});
+                    keys.append({SyntheticKey::Backspace, QString()});
+                }
+
+                if (typist.composes)
+                {
+                    keys.append({SyntheticKey::Preedit, characters});
+                    keys.append({SyntheticKey::Commit, characters});
+                }
+                else if (characters.length() == 1)
+                {
+                    keys.append({SyntheticKey::Text, characters});
+                }
+                else
+                {
+                    keys.append({SyntheticKey::Commit, characters});
+                }
+            }
+
+            keys.append({SyntheticKey::Return, QString()});
+        }
+
+        return keys;
+    }
+
+}
+
+class TypingSession
+{
+public:
+    TypingSession(const QString& text, const Typist& typist):
+        m_keys(keystrokes(text, typist)),
+        m_nextKey(0)
+    {
+        m_lesson.setTitle(QStringLiteral("Benchmark"));
+        m_lesson.setText(text);
+        m_trainingLineCore.setTrainingStats(&m_stats);
+        m_trainingLineCore.setActive(true);
+        m_lessonPainter.setTrainingLineCore(&m_trainingLineCore);
+        m_lessonPainter.setMaximumWidth(1000);
+        m_lessonPainter.setLesson(&m_lesson);
+        m_stats.startTraining();
+    }
+
+    int keyCount() const
+    {
+        return m_keys.count();
+    }
+
+    int keystrokeCount() const
+    {
+        int count = 0;
+
+        foreach (const SyntheticKey& key, m_keys)
+        {
+            // a preedit string is committed later, don't count it twice
+            if (key.kind == SyntheticKey::Commit)
+                count += key.text.length();
+            else if (key.kind != SyntheticKey::Preedit)
+                count++;
+        }
+
+        return count;
+    }
+
+    QTextDocument* document() const
+    {
+        return m_lessonPainter.findChild<QTextDocument*>();
+    }
+
+    TrainingLineCore* trainingLineCore()
+    {
+        return &m_trainingLineCore;
+    }
+
+    void typeNextKey()
+    {
+        if (m_nextKey == m_keys.count())
+        {
+            restart();
+        }
+
+        const SyntheticKey& key = m_keys.at(m_nextKey++);
+
+        switch (key.kind)
+        {
+        case SyntheticKey::Text:
+            sendKey(Qt::Key_unknown, key.text);
+            break;
+        case SyntheticKey::Backspace:
+            sendKey(Qt::Key_Backspace, QString());
+            break;
+        case SyntheticKey::Return:
+            sendKey(Qt::Key_Return, QStringLiteral("\r"));
+            break;
+        case SyntheticKey::Preedit:
+        {
+            QInputMethodEvent event(key.text, QList<QInputMethodEvent::Attribute>());
+            QCoreApplication::sendEvent(&m_trainingLineCore, &event);
+            break;
+        }
+        case SyntheticKey::Commit:
+        {
+            QInputMethodEvent event;
+            event.setCommitString(key.text);
+            QCoreApplication::sendEvent(&m_trainingLineCore, &event);
+            break;
+        }
+        }
+    }
+
+    void restart()
+    {
+        m_stats.reset();
+        m_lessonPainter.reset();
+        m_stats.startTraining();
+        m_nextKey = 0;
+    }
+
+private:
+    void sendKey(int key, const QString& text)
+    {
+        QKeyEvent event(QEvent::KeyPress, key, Qt::NoModifier, text);
+        QCoreApplication::sendEvent(&m_trainingLineCore, &event);
+    }
+
+    QVector<SyntheticKey> m_keys;
+    int m_nextKey;
+    Lesson m_lesson;
+    TrainingStats m_stats;
+    TrainingLineCore m_trainingLineCore;
+    LessonPainter m_lessonPainter;
+};
+
+class KTouchBench : public QObject
+{
+    Q_OBJECT
+private slots:
+    void initTestCase();
+    void keystroke_data();
+    void keystroke();
+    void keystrokeAllocations_data();
+    void keystrokeAllocations();
+    void keystrokeDocumentOperations_data();
+    void keystrokeDocumentOperations();
+private:
+    void addTypists();
+    Typist fetchTypist() const;
+    QString m_text;
+};
+
+void KTouchBench::initTestCase()
+{
+    QStandardPaths::setTestModeEnabled(true);
+    Preferences::setEnforceTypingErrorCorrection(true);
+    Preferences::setNextLineWithReturn(true);
+    Preferences::setNextLineWithSpace(false);
+    PreferencesCache::instance()->refresh();
+    m_text = lessonText();
+}
+
+void KTouchBench::addTypists()
+{
+    QTest::addColumn<qreal>("errorRate");
+    QTest::addColumn<int>("charactersPerEvent");
+    QTest::addColumn<bool>("composes");
+
+    QTest::newRow("accurate") << qreal(0) << 1 << false;
+    QTest::newRow("error-rate-5") << qreal(0.05) << 1 << false;
+    QTest::newRow("error-rate-20") << qreal(0.2) << 1 << false;
+    QTest::newRow("backspace") << qreal(1) << 1 << false;
+    QTest::newRow("ime-preedit") << qreal(0) << 1 << true;
+    QTest::newRow("ime-preedit-error-rate-5") << qreal(0.05) << 1 << true;
+    QTest::newRow("speed-4") << qreal(0) << 4 << false;
+    QTest::newRow("speed-16") << qreal(0) << 16 << false;
+}
+
+Typist KTouchBench::fetchTypist() const
+{
+    QFETCH(qreal, errorRate);
+    QFETCH(int, charactersPerEvent);
+    QFETCH(bool, composes);
+
+    const Typist typist = {errorRate, charactersPerEvent, composes};
+    return typist;
+}
+
+void KTouchBench::keystroke_data()
+{
+    addTypists();
+}
+
+void KTouchBench::keystroke()
+{
+    TypingSession session(m_text, fetchTypist());
+
+    QBENCHMARK
+    {
+        session.typeNextKey();
+    }
+}
+
+void KTouchBench::keystrokeAllocations_data()
+{
+    addTypists();
+}
+
+void KTouchBench::keystrokeAllocations()
+{
+    if (!AllocationCounter::isAvailable())
+        QSKIP("allocations can only be counted with glibc");
+
+    TypingSession session(m_text, fetchTypist());
+
+    // the first run grows the buffers which are reused afterwards
+    for (int i = 0; i < session.keyCount(); i++)
+    {
+        session.typeNextKey();
+    }
+
+    session.restart();
+
+    const qint64 allocationCount = AllocationCounter::allocationCount();
+
+    for (int i = 0; i < session.keyCount(); i++)
+    {
+        session.typeNextKey();
+    }
+
+    QTest::setBenchmarkResult(qreal(AllocationCounter::allocationCount() - allocationCount) / session.keystrokeCount(), QTest::Events);
+}
+
+void KTouchBench::keystrokeDocumentOperations_data()
+{
+    addTypists();
+}
+
+void KTouchBench::keystrokeDocumentOperations()
+{
+    TypingSession session(m_text, fetchTypist());
+    QSignalSpy spy(session.document(), &QTextDocument::contentsChange);
+
+    for (int i = 0; i < session.keyCount(); i++)
+    {
+        session.typeNextKey();
+    }
+
+    QCOMPARE(session.trainingLineCore()->referenceLine(), QString());
+    QTest::setBenchmarkResult(qreal(spy.count()) / session.keystrokeCount(), QTest::Events);
+}
+
+QTEST_MAIN(KTouchBench)
+
+#include "ktouchbench.moc"
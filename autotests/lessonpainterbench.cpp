@@ -0,0 +1,169 @@
+/*
+ *  Copyright 2026  Sebastian Gottfried <sebastian.gottfried@posteo.de>
+ *
+ *  This program is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU General Public License as
+ *  published by the Free Software Foundation; either version 2 of
+ *  the License, or (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <QInputMethodEvent>
+#include <QKeyEvent>
+#include <QStandardPaths>
+#include <QTextDocument>
+#include <QtTest>
+
+#include "core/lesson.h"
+#include "core/trainingstats.h"
+#include "declarativeitems/lessonpainter.h"
+#include "declarativeitems/traininglinecore.h"
+#include "preferences.h"
+#include "preferencescache.h"
+
+/*
+ * Types the lines of a lesson into a windowless LessonPainter and counts
+ * the operations on its QTextDocument.
+ */
+
+namespace
+{
+    const int lineLength = 60;
+
+    QStringList lessonLines()
+    {
+        const QStringList lines = {
+            QStringLiteral("the quick brown fox jumps over the lazy dog, then sleeps a bit."),
+            QStringLiteral("pack my box with five dozen liquor jugs and carry it back home.")
+        };
+        QStringList result;
+
+        foreach (const QString& line, lines)
+        {
+            result.append(line.left(lineLength));
+        }
+
+        return result;
+    }
+
+    void sendKey(QQuickItem* item, int key, const QString& text)
+    {
+        QKeyEvent event(QEvent::KeyPress, key, Qt::NoModifier, text);
+        QCoreApplication::sendEvent(item, &event);
+    }
+
+    void sendInputMethodEvent(QQuickItem* item, const QString& preeditString, const QString& commitString)
+    {
+        QInputMethodEvent event(preeditString, QList<QInputMethodEvent::Attribute>());
+        event.setCommitString(commitString);
+        QCoreApplication::sendEvent(item, &event);
+    }
+}
+
+class LessonPainterBench : public QObject
+{
+    Q_OBJECT
+private slots:
+    void initTestCase();
+    void typeLines_data();
+    void typeLines();
+};
+
+void LessonPainterBench::initTestCase()
+{
+    QStandardPaths::setTestModeEnabled(true);
+    Preferences::setEnforceTypingErrorCorrection(true);
+    Preferences::setNextLineWithReturn(true);
+    Preferences::setNextLineWithSpace(false);
+    PreferencesCache::instance()->refresh();
+}
+
+void LessonPainterBench::typeLines_data()
+{
+    // every errorInterval-th character is mistyped first and corrected with backspace
+    QTest::addColumn<int>("errorInterval");
+    QTest::addColumn<bool>("composes");
+
+    QTest::newRow("accurate") << 0 << false;
+    QTest::newRow("error-every-10") << 10 << false;
+    QTest::newRow("error-every-character") << 1 << false;
+    QTest::newRow("ime-preedit") << 0 << true;
+}
+
+void LessonPainterBench::typeLines()
+{
+    QFETCH(int, errorInterval);
+    QFETCH(bool, composes);
+
+    const QStringList lines = lessonLines();
+
+    Lesson lesson;
+    lesson.setTitle(QStringLiteral("Benchmark"));
+    lesson.setText(lines.join(QLatin1Char('\n')));
+    TrainingStats stats;
+    TrainingLineCore trainingLineCore;
+    trainingLineCore.setTrainingStats(&stats);
+    trainingLineCore.setActive(true);
+    LessonPainter lessonPainter;
+    lessonPainter.setTrainingLineCore(&trainingLineCore);
+    lessonPainter.setMaximumWidth(1000);
+    lessonPainter.setLesson(&lesson);
+
+    QSignalSpy spy(lessonPainter.findChild<QTextDocument*>(), &QTextDocument::contentsChange);
+    int errorCount = 0;
+
+    foreach (const QString& line, lines)
+    {
+        QCOMPARE(line.length(), lineLength);
+        QCOMPARE(trainingLineCore.referenceLine(), line);
+
+        for (int i = 0; i < line.length(); i++)
+        {
+            const QString character(line.at(i));
+
+            if (errorInterval > 0 && i % errorInterval == 0)
+            {
+                sendKey(&trainingLineCore, Qt::Key_unknown, QString(character == QLatin1String("x")? QLatin1Char('z'): QLatin1Char('x')));
+                sendKey(&trainingLineCore, Qt::Key_Backspace, QString());
+                errorCount++;
+            }
+
+            if (composes)
+            {
+                sendInputMethodEvent(&trainingLineCore, character, QString());
+                sendInputMethodEvent(&trainingLineCore, QString(), character);
+            }
+            else
+            {
+                sendKey(&trainingLineCore, Qt::Key_unknown, character);
+            }
+        }
+
+        QCOMPARE(trainingLineCore.actualLine(), line);
+        sendKey(&trainingLineCore, Qt::Key_Return, QStringLiteral("\r"));
+    }
+
+    QCOMPARE(trainingLineCore.referenceLine(), QString());
+
+    // each keystroke changes the format of the glyph it's typed at, errors
+    // replace it with the wrong character and back on backspace. Advancing
+    // to the next line doesn't touch the document, its placeholders are
+    // already in place.
+    if (!composes)
+    {
+        QCOMPARE(spy.count(), lines.count() * lineLength + 2 * errorCount);
+    }
+
+    QTest::setBenchmarkResult(spy.count(), QTest::Events);
+}
+
+QTEST_MAIN(LessonPainterBench)
+
+#include "lessonpainterbench.moc"
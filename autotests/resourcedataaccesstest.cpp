@@ -0,0 +1,224 @@
+/*
+ *  Copyright 2026  Sebastian Gottfried <sebastian.gottfried@posteo.de>
+ *
+ *  This program is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU General Public License as
+ *  published by the Free Software Foundation; either version 2 of
+ *  the License, or (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <QFile>
+#include <QFileInfo>
+#include <QStandardPaths>
+#include <QTemporaryDir>
+#include <QtTest>
+
+#include "core/course.h"
+#include "core/dataindex.h"
+#include "core/key.h"
+#include "core/keyboardlayout.h"
+#include "core/keychar.h"
+#include "core/lesson.h"
+#include "core/resourcedataaccess.h"
+#include "core/specialkey.h"
+
+/*
+ * Stores every built-in course and keyboard layout, loads the result back
+ * and stores it again. The reloaded resource has to equal the original and
+ * both stored files have to be byte-identical.
+ */
+
+namespace
+{
+    // the declaration written by the former QDomDocument based writer
+    const char xmlHeader[] = "<?xml version=\"1.0\"?>\n";
+
+    QByteArray readFile(const QString& path)
+    {
+        QFile file(path);
+
+        if (!file.open(QIODevice::ReadOnly))
+            return QByteArray();
+
+        return file.readAll();
+    }
+}
+
+class ResourceDataAccessTest : public QObject
+{
+    Q_OBJECT
+private slots:
+    void initTestCase();
+    void storeKeyboardLayout_data();
+    void storeKeyboardLayout();
+    void storeCourse_data();
+    void storeCourse();
+private:
+    void compareKeyboardLayouts(const KeyboardLayout& actual, const KeyboardLayout& expected);
+    void compareCourses(const Course& actual, const Course& expected);
+    QTemporaryDir m_dir;
+    DataIndex m_dataIndex;
+};
+
+void ResourceDataAccessTest::initTestCase()
+{
+    // the built-in resources are looked up like the ones of the application
+    QCoreApplication::setApplicationName(QStringLiteral("ktouch"));
+    QStandardPaths::setTestModeEnabled(true);
+
+    QVERIFY(m_dir.isValid());
+
+    ResourceDataAccess dataAccess;
+    QVERIFY(dataAccess.fillDataIndex(&m_dataIndex));
+    QVERIFY(m_dataIndex.keyboardLayoutCount() >= 40);
+    QVERIFY(m_dataIndex.courseCount() >= 40);
+}
+
+void ResourceDataAccessTest::storeKeyboardLayout_data()
+{
+    QTest::addColumn<QString>("path");
+
+    for (int i = 0; i < m_dataIndex.keyboardLayoutCount(); i++)
+    {
+        const QString path = m_dataIndex.keyboardLayout(i)->path();
+        QTest::newRow(QFileInfo(path).fileName().toUtf8().constData()) << path;
+    }
+}
+
+void ResourceDataAccessTest::storeKeyboardLayout()
+{
+    QFETCH(QString, path);
+
+    ResourceDataAccess dataAccess;
+    const QString firstPath = m_dir.filePath(QStringLiteral("first.xml"));
+    const QString secondPath = m_dir.filePath(QStringLiteral("second.xml"));
+
+    KeyboardLayout original;
+    QVERIFY(dataAccess.loadKeyboardLayout(path, &original));
+    QVERIFY(dataAccess.storeKeyboardLayout(firstPath, &original));
+    QVERIFY(readFile(firstPath).startsWith(QByteArray(xmlHeader) + "<keyboardLayout>"));
+
+    KeyboardLayout reloaded;
+    QVERIFY(dataAccess.loadKeyboardLayout(firstPath, &reloaded));
+    compareKeyboardLayouts(reloaded, original);
+    if (QTest::currentTestFailed())
+        return;
+
+    QVERIFY(dataAccess.storeKeyboardLayout(secondPath, &reloaded));
+    QCOMPARE(readFile(secondPath), readFile(firstPath));
+}
+
+void ResourceDataAccessTest::storeCourse_data()
+{
+    QTest::addColumn<QString>("path");
+
+    for (int i = 0; i < m_dataIndex.courseCount(); i++)
+    {
+        const QString path = m_dataIndex.course(i)->path();
+        QTest::newRow(QFileInfo(path).fileName().toUtf8().constData()) << path;
+    }
+}
+
+void ResourceDataAccessTest::storeCourse()
+{
+    QFETCH(QString, path);
+
+    ResourceDataAccess dataAccess;
+    const QString firstPath = m_dir.filePath(QStringLiteral("first.xml"));
+    const QString secondPath = m_dir.filePath(QStringLiteral("second.xml"));
+
+    Course original;
+    QVERIFY(dataAccess.loadCourse(path, &original));
+    QVERIFY(dataAccess.storeCourse(firstPath, &original));
+    QVERIFY(readFile(firstPath).startsWith(QByteArray(xmlHeader) + "<course>"));
+
+    Course reloaded;
+    QVERIFY(dataAccess.loadCourse(firstPath, &reloaded));
+    compareCourses(reloaded, original);
+    if (QTest::currentTestFailed())
+        return;
+
+    QVERIFY(dataAccess.storeCourse(secondPath, &reloaded));
+    QCOMPARE(readFile(secondPath), readFile(firstPath));
+}
+
+void ResourceDataAccessTest::compareKeyboardLayouts(const KeyboardLayout& actual, const KeyboardLayout& expected)
+{
+    QCOMPARE(actual.id(), expected.id());
+    QCOMPARE(actual.title(), expected.title());
+    QCOMPARE(actual.name(), expected.name());
+    QCOMPARE(actual.width(), expected.width());
+    QCOMPARE(actual.height(), expected.height());
+    QCOMPARE(actual.keyCount(), expected.keyCount());
+
+    for (int i = 0; i < expected.keyCount(); i++)
+    {
+        AbstractKey* const actualKey = actual.key(i);
+        AbstractKey* const expectedKey = expected.key(i);
+
+        QCOMPARE(actualKey->left(), expectedKey->left());
+        QCOMPARE(actualKey->top(), expectedKey->top());
+        QCOMPARE(actualKey->width(), expectedKey->width());
+        QCOMPARE(actualKey->height(), expectedKey->height());
+
+        if (Key* const expectedCharKey = qobject_cast<Key*>(expectedKey))
+        {
+            Key* const actualCharKey = qobject_cast<Key*>(actualKey);
+            QVERIFY(actualCharKey);
+            QCOMPARE(actualCharKey->fingerIndex(), expectedCharKey->fingerIndex());
+            QCOMPARE(actualCharKey->hasHapticMarker(), expectedCharKey->hasHapticMarker());
+            QCOMPARE(actualCharKey->keyCharCount(), expectedCharKey->keyCharCount());
+
+            for (int j = 0; j < expectedCharKey->keyCharCount(); j++)
+            {
+                KeyChar* const actualKeyChar = actualCharKey->keyChar(j);
+                KeyChar* const expectedKeyChar = expectedCharKey->keyChar(j);
+
+                QCOMPARE(actualKeyChar->value(), expectedKeyChar->value());
+                QCOMPARE(int(actualKeyChar->position()), int(expectedKeyChar->position()));
+                QCOMPARE(actualKeyChar->modifier(), expectedKeyChar->modifier());
+            }
+        }
+
+        if (SpecialKey* const expectedSpecialKey = qobject_cast<SpecialKey*>(expectedKey))
+        {
+            SpecialKey* const actualSpecialKey = qobject_cast<SpecialKey*>(actualKey);
+            QVERIFY(actualSpecialKey);
+            QCOMPARE(int(actualSpecialKey->type()), int(expectedSpecialKey->type()));
+            QCOMPARE(actualSpecialKey->modifierId(), expectedSpecialKey->modifierId());
+            QCOMPARE(actualSpecialKey->label(), expectedSpecialKey->label());
+        }
+    }
+}
+
+void ResourceDataAccessTest::compareCourses(const Course& actual, const Course& expected)
+{
+    QCOMPARE(actual.id(), expected.id());
+    QCOMPARE(actual.title(), expected.title());
+    QCOMPARE(actual.description(), expected.description());
+    QCOMPARE(actual.keyboardLayoutName(), expected.keyboardLayoutName());
+    QCOMPARE(actual.lessonCount(), expected.lessonCount());
+
+    for (int i = 0; i < expected.lessonCount(); i++)
+    {
+        Lesson* const actualLesson = actual.lesson(i);
+        Lesson* const expectedLesson = expected.lesson(i);
+
+        QCOMPARE(actualLesson->id(), expectedLesson->id());
+        QCOMPARE(actualLesson->title(), expectedLesson->title());
+        QCOMPARE(actualLesson->newCharacters(), expectedLesson->newCharacters());
+        QCOMPARE(actualLesson->text(), expectedLesson->text());
+    }
+}
+
+QTEST_GUILESS_MAIN(ResourceDataAccessTest)
+
+#include "resourcedataaccesstest.moc"
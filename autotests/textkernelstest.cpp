@@ -0,0 +1,419 @@
+/*
+ *  Copyright 2026  Sebastian Gottfried <sebastian.gottfried@posteo.de>
+ *
+ *  This program is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU General Public License as
+ *  published by the Free Software Foundation; either version 2 of
+ *  the License, or (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <QRandomGenerator>
+#include <QString>
+#include <QtTest>
+
+#include "core/characterset.h"
+#include "core/textkernels.h"
+
+/*
+ * Compares the vectorized kernels with the scalar loops. The SSE2 variants
+ * work on 8 UTF-16 units at a time and the AVX2 ones on 16, so the lengths
+ * and positions tried span a few blocks of both, including the remainders
+ * handled by the scalar tails.
+ */
+
+namespace
+{
+    const int maxLength = 40;
+
+    QString filler(int length)
+    {
+        QString text;
+
+        for (int i = 0; i < length; i++)
+        {
+            text += QChar(i % 2? 0x00e4: 'a' + i % 26);
+        }
+
+        return text;
+    }
+}
+
+class TextKernelsTest : public QObject
+{
+    Q_OBJECT
+private slots:
+    void initTestCase();
+    void cleanup();
+    void mismatch_data();
+    void mismatch();
+    void replaceLineBreaks_data();
+    void replaceLineBreaks();
+    void indexOfMissing_data();
+    void indexOfMissing();
+    void collectDistinct_data();
+    void collectDistinct();
+    void benchmarkMismatch_data();
+    void benchmarkMismatch();
+    void benchmarkReplaceLineBreaks_data();
+    void benchmarkReplaceLineBreaks();
+    void benchmarkIndexOfMissing_data();
+    void benchmarkIndexOfMissing();
+    void benchmarkCollectDistinct_data();
+    void benchmarkCollectDistinct();
+private:
+    void addImplementations();
+    void addBenchmarkRows();
+    void useImplementation(int implementation);
+    TextKernels::Implementation m_defaultImplementation;
+};
+
+void TextKernelsTest::initTestCase()
+{
+    m_defaultImplementation = TextKernels::implementation();
+}
+
+void TextKernelsTest::cleanup()
+{
+    TextKernels::setImplementation(m_defaultImplementation);
+}
+
+void TextKernelsTest::addImplementations()
+{
+    QTest::addColumn<int>("implementation");
+
+    QTest::newRow("sse2") << int(TextKernels::Sse2);
+    QTest::newRow("avx2") << int(TextKernels::Avx2);
+}
+
+void TextKernelsTest::addBenchmarkRows()
+{
+    QTest::addColumn<int>("implementation");
+    QTest::addColumn<int>("length");
+
+    const QVector<int> lengths = {8, 16, 60, 1000};
+
+    foreach (int length, lengths)
+    {
+        QTest::addRow("scalar-%d", length) << int(TextKernels::Scalar) << length;
+        QTest::addRow("sse2-%d", length) << int(TextKernels::Sse2) << length;
+        QTest::addRow("avx2-%d", length) << int(TextKernels::Avx2) << length;
+    }
+}
+
+void TextKernelsTest::useImplementation(int implementation)
+{
+    if (!TextKernels::setImplementation(TextKernels::Implementation(implementation)))
+        QSKIP("not supported by this CPU");
+}
+
+void TextKernelsTest::mismatch_data()
+{
+    addImplementations();
+}
+
+void TextKernelsTest::mismatch()
+{
+    QFETCH(int, implementation);
+
+    useImplementation(implementation);
+
+    for (int length = 0; length <= maxLength; length++)
+    {
+        const QString first = filler(length);
+
+        // position length leaves both texts equal
+        for (int pos = 0; pos <= length; pos++)
+        {
+            QString second = first;
+
+            if (pos < length)
+            {
+                second[pos] = QChar(first.at(pos).unicode() ^ 0x8000);
+            }
+
+            TextKernels::setImplementation(TextKernels::Scalar);
+            const int expected = TextKernels::mismatch(first.constData(), second.constData(), length);
+            TextKernels::setImplementation(TextKernels::Implementation(implementation));
+            const int actual = TextKernels::mismatch(first.constData(), second.constData(), length);
+
+            QCOMPARE(expected, pos);
+            QCOMPARE(actual, expected);
+        }
+    }
+}
+
+void TextKernelsTest::replaceLineBreaks_data()
+{
+    addImplementations();
+}
+
+void TextKernelsTest::replaceLineBreaks()
+{
+    QFETCH(int, implementation);
+
+    useImplementation(implementation);
+
+    // the line breaks, followed by characters close to them or equal to
+    // them in the lower byte
+    const QString characters = QStringLiteral("\n\r\u2029\t\v\u2028\u0a0a\u0d0d\uff0a");
+
+    for (int length = 1; length <= maxLength; length++)
+    {
+        for (int pos = 0; pos < length; pos++)
+        {
+            foreach (const QChar& c, characters)
+            {
+                QString text = filler(length);
+                text[pos] = c;
+                // a second one in the last position, to cover the tail
+                text[length - 1] = c;
+
+                QString expected = text;
+                TextKernels::setImplementation(TextKernels::Scalar);
+                TextKernels::replaceLineBreaks(expected);
+
+                QString actual = text;
+                TextKernels::setImplementation(TextKernels::Implementation(implementation));
+                TextKernels::replaceLineBreaks(actual);
+
+                QCOMPARE(actual, expected);
+            }
+        }
+    }
+}
+
+void TextKernelsTest::indexOfMissing_data()
+{
+    addImplementations();
+}
+
+void TextKernelsTest::indexOfMissing()
+{
+    QFETCH(int, implementation);
+
+    useImplementation(implementation);
+
+    const QString astral = QString::fromUcs4(U"\U0001f600");
+    const QString missingAstral = QString::fromUcs4(U"\U0001f601");
+    // the lookup tables only cover ASCII, test sets with and without other characters
+    const CharacterSet asciiSet(QStringLiteral("abcdefghijklmnopqrstuvwxyz .,"));
+    const CharacterSet mixedSet(QStringLiteral("abcdefghijklmnopqrstuvwxyz .,ä中") + astral);
+    const QString asciiFill = QStringLiteral("the quick brown fox, jumps.");
+    const QString mixedFill = QStringLiteral("foxä 中j") + astral + QStringLiteral("umps");
+
+    const QStringList missing = {
+        QStringLiteral("Z"),
+        QStringLiteral("ö"),
+        QStringLiteral("丮"),
+        missingAstral,
+        QString(QChar(0xd83d)),
+        QString(QChar(0xde00))
+    };
+
+    for (int length = 0; length <= maxLength; length++)
+    {
+        for (int set = 0; set < 2; set++)
+        {
+            const CharacterSet& characterSet = set == 0? asciiSet: mixedSet;
+            const QString fill = set == 0? asciiFill: mixedFill;
+            QString complete;
+
+            while (complete.length() < length)
+            {
+                complete += fill;
+            }
+
+            complete.truncate(length);
+
+            // a truncated surrogate pair at the end is a missing character itself
+            for (int pos = 0; pos <= length; pos++)
+            {
+                foreach (const QString& m, missing)
+                {
+                    const QString text = complete.left(pos) + m + complete.mid(pos);
+
+                    TextKernels::setImplementation(TextKernels::Scalar);
+                    const int expected = TextKernels::indexOfMissing(text.constData(), text.length(), characterSet);
+                    TextKernels::setImplementation(TextKernels::Implementation(implementation));
+                    const int actual = TextKernels::indexOfMissing(text.constData(), text.length(), characterSet);
+
+                    QCOMPARE(actual, expected);
+                }
+
+                const QString text = complete.left(pos);
+
+                TextKernels::setImplementation(TextKernels::Scalar);
+                const int expected = TextKernels::indexOfMissing(text.constData(), text.length(), characterSet);
+                TextKernels::setImplementation(TextKernels::Implementation(implementation));
+                const int actual = TextKernels::indexOfMissing(text.constData(), text.length(), characterSet);
+
+                QCOMPARE(actual, expected);
+            }
+        }
+    }
+}
+
+void TextKernelsTest::collectDistinct_data()
+{
+    addImplementations();
+}
+
+void TextKernelsTest::collectDistinct()
+{
+    QFETCH(int, implementation);
+
+    useImplementation(implementation);
+
+    const QString pool = QStringLiteral("asdfjkl; ä中\n") + QString::fromUcs4(U"\U0001f600");
+    QRandomGenerator random(7);
+
+    for (int length = 0; length <= 4 * maxLength; length++)
+    {
+        QString text;
+
+        while (text.length() < length)
+        {
+            const int i = random.bounded(pool.length() - 1);
+            // the surrogate pair at the end of the pool is taken as a whole
+            text += pool.at(i).isHighSurrogate()? pool.mid(i, 2): QString(pool.at(i));
+        }
+
+        CharacterSet expectedSeen(QStringLiteral("a"));
+        QString expected;
+        TextKernels::setImplementation(TextKernels::Scalar);
+        TextKernels::collectDistinct(text.constData(), text.length(), expectedSeen, expected);
+
+        CharacterSet actualSeen(QStringLiteral("a"));
+        QString actual;
+        TextKernels::setImplementation(TextKernels::Implementation(implementation));
+        TextKernels::collectDistinct(text.constData(), text.length(), actualSeen, actual);
+
+        QCOMPARE(actual, expected);
+        QCOMPARE(actualSeen.count(), expectedSeen.count());
+    }
+}
+
+void TextKernelsTest::benchmarkMismatch_data()
+{
+    addBenchmarkRows();
+}
+
+void TextKernelsTest::benchmarkMismatch()
+{
+    QFETCH(int, implementation);
+    QFETCH(int, length);
+
+    useImplementation(implementation);
+
+    const QString first = filler(length);
+    const QString second = first;
+    int result = 0;
+
+    QBENCHMARK
+    {
+        result = TextKernels::mismatch(first.constData(), second.constData(), length);
+    }
+
+    QCOMPARE(result, length);
+}
+
+void TextKernelsTest::benchmarkReplaceLineBreaks_data()
+{
+    addBenchmarkRows();
+}
+
+void TextKernelsTest::benchmarkReplaceLineBreaks()
+{
+    QFETCH(int, implementation);
+    QFETCH(int, length);
+
+    useImplementation(implementation);
+
+    QString text = filler(length);
+    text[length - 1] = QLatin1Char('\n');
+
+    QBENCHMARK
+    {
+        TextKernels::replaceLineBreaks(text);
+    }
+
+    QCOMPARE(text.at(length - 1), QChar(QLatin1Char(' ')));
+}
+
+void TextKernelsTest::benchmarkIndexOfMissing_data()
+{
+    addBenchmarkRows();
+}
+
+void TextKernelsTest::benchmarkIndexOfMissing()
+{
+    QFETCH(int, implementation);
+    QFETCH(int, length);
+
+    useImplementation(implementation);
+
+    // lesson texts are mostly ASCII
+    QString text;
+
+    while (text.length() < length)
+    {
+        text += QStringLiteral("the quick brown fox jumps over the lazy dog. ");
+    }
+
+    text.truncate(length);
+
+    const CharacterSet set(QStringLiteral("abcdefghijklmnopqrstuvwxyz ."));
+    int result = 0;
+
+    QBENCHMARK
+    {
+        result = TextKernels::indexOfMissing(text.constData(), length, set);
+    }
+
+    QCOMPARE(result, length);
+}
+
+void TextKernelsTest::benchmarkCollectDistinct_data()
+{
+    addBenchmarkRows();
+}
+
+void TextKernelsTest::benchmarkCollectDistinct()
+{
+    QFETCH(int, implementation);
+    QFETCH(int, length);
+
+    useImplementation(implementation);
+
+    QString text;
+
+    while (text.length() < length)
+    {
+        text += QStringLiteral("the quick brown fox jumps over the lazy dog. ");
+    }
+
+    text.truncate(length);
+
+    QString distinct;
+
+    QBENCHMARK
+    {
+        CharacterSet seen;
+        distinct.clear();
+        TextKernels::collectDistinct(text.constData(), length, seen, distinct);
+    }
+
+    QVERIFY(!distinct.isEmpty());
+}
+
+QTEST_GUILESS_MAIN(TextKernelsTest)
+
+#include "textkernelstest.moc"
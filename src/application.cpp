@@ -24,6 +24,8 @@
 #include <QQmlContext>
 #include <QQuickStyle>
 #include <QStandardPaths>
+#include <QThread>
+#include <QtConcurrent>
 
 #include <KLocalizedContext>
 #include <Kdelibs4ConfigMigrator>
@@ -33,7 +35,11 @@
 #include "bindings/stringformatter.h"
 #include "declarativeitems/griditem.h"
 #include "declarativeitems/kcolorschemeproxy.h"
+#include "declarativeitems/keyboardhighlightcontroller.h"
+#include "declarativeitems/keyboardrenderer.h"
+#include "declarativeitems/lessonkeymask.h"
 #include "declarativeitems/lessonpainter.h"
+#include "declarativeitems/lessonrenderer.h"
 #include "declarativeitems/lessontexthighlighteritem.h"
 #include "declarativeitems/preferencesproxy.h"
 #include "declarativeitems/scalebackgrounditem.h"
@@ -47,35 +53,156 @@
 #include "core/profile.h"
 #include "core/trainingstats.h"
 #include "core/dataindex.h"
+#include "core/dataindexwatcher.h"
 #include "core/dataaccess.h"
 #include "core/profiledataaccess.h"
+#include "core/resourcedataaccess.h"
+#include "core/userdataaccess.h"
 #include "models/resourcemodel.h"
 #include "models/lessonmodel.h"
 #include "models/categorizedresourcesortfilterproxymodel.h"
 #include "models/learningprogressmodel.h"
 #include "models/errorsmodel.h"
+#include "startuptrace.h"
 
 
+namespace
+{
+    void migrateKde4Database()
+    {
+        Kdelibs4Migration migration;
+        const QDir dataDir = QDir(QStandardPaths::writableLocation(QStandardPaths::DataLocation));
+        if (!dataDir.exists())
+        {
+            dataDir.mkpath(dataDir.path());
+        }
+        const QString dbPath = dataDir.filePath(QStringLiteral("profiles.db"));
+        const QString oldDbPath = migration.locateLocal("data", QStringLiteral("ktouch/profiles.db"));
+        if (!QFile(dbPath).exists() && !oldDbPath.isEmpty())
+        {
+            QFile(oldDbPath).copy(dbPath);
+        }
+    }
+
+    DataIndex* loadBuiltInDataIndex(QThread* targetThread)
+    {
+        StartupTrace::Span span(QStringLiteral("built-in data index"));
+        return ResourceDataAccess::loadDataIndex(targetThread);
+    }
+
+    DataIndex* loadUserDataIndex(QThread* targetThread)
+    {
+        {
+            StartupTrace::Span span(QStringLiteral("KDE 4 database migration"));
+            migrateKde4Database();
+        }
+
+        {
+            // the connection stays open for the data index below
+            StartupTrace::Span span(QStringLiteral("database schema check"));
+            UserDataAccess userDataAccess;
+            userDataAccess.openDatabase();
+        }
+
+        StartupTrace::Span span(QStringLiteral("user data index"));
+        return UserDataAccess::loadDataIndex(targetThread);
+    }
+
+    void mergeDataIndex(DataIndex* source, DataIndex* target)
+    {
+        for (int i = 0; i < source->courseCount(); i++)
+        {
+            target->addCourse(source->course(i));
+        }
+
+        for (int i = 0; i < source->keyboardLayoutCount(); i++)
+        {
+            target->addKeyboardLayout(source->keyboardLayout(i));
+        }
+
+        target->setIsValid(target->isValid() && source->isValid());
+
+        delete source;
+    }
+}
+
 Application::Application(int& argc, char** argv, int flags):
     QApplication(argc, argv, flags),
-    m_dataIndex(new DataIndex(this))
+    m_dataIndex(new DataIndex(this)),
+    m_loadingPending(false),
+    m_startupTraceWritten(false)
 {
+    StartupTrace::Span span(QStringLiteral("application setup"));
+
     registerQmlTypes();
-    migrateKde4Files();
+    migrateKde4Config();
 
     QQuickStyle::setStyle("Default");
+}
+
+void Application::startLoading(const QString& startupTraceFile)
+{
+    Q_ASSERT(!m_loadingPending);
+
+    m_startupTraceFile = startupTraceFile;
+
+    if (!m_startupTraceFile.isEmpty())
+    {
+        connect(this, &QCoreApplication::aboutToQuit, this, &Application::writeStartupTrace);
+    }
 
-    DataAccess dataAccess;
-    dataAccess.loadDataIndex(m_dataIndex);
+    // the built-in and the user data index are independent of each
+    // other, so they are loaded concurrently while the GUI thread
+    // continues with setting up the windows and compiling the QML code
+    QThread* const guiThread = thread();
+    m_builtInDataIndexFuture = QtConcurrent::run(loadBuiltInDataIndex, guiThread);
+    m_userDataIndexFuture = QtConcurrent::run(loadUserDataIndex, guiThread);
+    m_loadingPending = true;
 }
 
 DataIndex* Application::dataIndex()
 {
     Application* app = qobject_cast<Application*>(QCoreApplication::instance());
 
+    if (app->m_loadingPending)
+    {
+        app->finishLoading();
+    }
+
     return app->m_dataIndex;
 }
 
+void Application::reportFirstFrame()
+{
+    Application* app = qobject_cast<Application*>(QCoreApplication::instance());
+
+    StartupTrace::record(QStringLiteral("first frame"), 0, StartupTrace::now());
+    app->writeStartupTrace();
+}
+
+void Application::finishLoading()
+{
+    StartupTrace::Span span(QStringLiteral("data index merge"));
+
+    m_loadingPending = false;
+    m_dataIndex->setIsValid(true);
+
+    // keep the order of the serial implementation: built-in resources first
+    mergeDataIndex(m_builtInDataIndexFuture.result(), m_dataIndex);
+    mergeDataIndex(m_userDataIndexFuture.result(), m_dataIndex);
+
+    new DataIndexWatcher(m_dataIndex, this);
+}
+
+void Application::writeStartupTrace()
+{
+    if (m_startupTraceFile.isEmpty() || m_startupTraceWritten)
+        return;
+
+    m_startupTraceWritten = true;
+    StartupTrace::writeChromeTrace(m_startupTraceFile);
+}
+
 QPointer<ResourceEditor>& Application::resourceEditorRef()
 {
     Application* app = qobject_cast<Application*>(QCoreApplication::instance());
@@ -108,6 +235,8 @@ QStringList& Application::qmlImportPaths()
 
 void Application::registerQmlTypes()
 {
+    StartupTrace::Span span(QStringLiteral("QML type registration"));
+
     qmlRegisterType<KeyboardLayout>("ktouch", 1, 0, "KeyboardLayout");
     qmlRegisterType<AbstractKey>("ktouch", 1, 0, "AbstractKey");
     qmlRegisterType<Key>("ktouch", 1, 0, "Key");
@@ -133,30 +262,22 @@ void Application::registerQmlTypes()
     qmlRegisterType<GridItem>("ktouch", 1, 0 , "LineGrid");
     qmlRegisterType<ScaleBackgroundItem>("ktouch", 1, 0, "ScaleBackgroundItem");
     qmlRegisterType<LessonPainter>("ktouch", 1, 0, "LessonPainter");
+    qmlRegisterType<LessonRenderer>("ktouch", 1, 0, "LessonRenderer");
     qmlRegisterType<LessonTextHighlighterItem>("ktouch", 1, 0, "LessonTextHighlighter");
     qmlRegisterType<TrainingLineCore>("ktouch", 1, 0, "TrainingLineCore");
+    qmlRegisterType<KeyboardHighlightController>("ktouch", 1, 0, "KeyboardHighlightController");
+    qmlRegisterType<KeyboardRenderer>("ktouch", 1, 0, "KeyboardRenderer");
+    qmlRegisterType<LessonKeyMask>("ktouch", 1, 0, "LessonKeyMask");
     qmlRegisterType<KColorSchemeProxy>("ktouch", 1, 0, "KColorScheme");
 }
 
-void Application::migrateKde4Files()
+void Application::migrateKde4Config()
 {
+    StartupTrace::Span span(QStringLiteral("KDE 4 config migration"));
+
     QStringList configFiles;
     configFiles << QStringLiteral("ktouchrc");
     Kdelibs4ConfigMigrator confMigrator(QStringLiteral("ktouch"));
     confMigrator.setConfigFiles(configFiles);
     confMigrator.migrate();
-
-    Kdelibs4Migration migration;
-    const QDir dataDir = QDir(QStandardPaths::writableLocation(QStandardPaths::DataLocation));
-    if (!dataDir.exists())
-    {
-        dataDir.mkpath(dataDir.path());
-    }
-    const QString dbPath = dataDir.filePath(QStringLiteral("profiles.db"));
-    const QString oldDbPath = migration.locateLocal("data", QStringLiteral("ktouch/profiles.db"));
-    if (!QFile(dbPath).exists() && !oldDbPath.isEmpty())
-    {
-        QFile(oldDbPath).copy(dbPath);
-    }
-
 }
@@ -19,6 +19,7 @@
 #define APPLICATION_H
 
 #include <QApplication>
+#include <QFuture>
 #include <QPointer>
 
 #include "editor/resourceeditor.h"
@@ -31,14 +32,23 @@ class Application : public QApplication
     Q_OBJECT
 public:
     Application(int& argc, char** argv, int flags = ApplicationFlags);
+    void startLoading(const QString& startupTraceFile = QString());
     static DataIndex* dataIndex();
+    static void reportFirstFrame();
     static void setupDeclarativeBindings(QQmlEngine* qmlEngine);
     static QPointer<ResourceEditor>& resourceEditorRef();
     QStringList& qmlImportPaths();
 private:
     void registerQmlTypes();
-    void migrateKde4Files();
+    void migrateKde4Config();
+    void finishLoading();
+    void writeStartupTrace();
     DataIndex* m_dataIndex;
+    QFuture<DataIndex*> m_builtInDataIndexFuture;
+    QFuture<DataIndex*> m_userDataIndexFuture;
+    bool m_loadingPending;
+    QString m_startupTraceFile;
+    bool m_startupTraceWritten;
     QPointer<ResourceEditor> m_resourceEditorRef;
     QStringList m_qmlImportPaths;
 };
@@ -0,0 +1,105 @@
+/*
+ *  Copyright 2026  Sebastian Gottfried <sebastian.gottfried@posteo.de>
+ *
+ *  This program is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU General Public License as
+ *  published by the Free Software Foundation; either version 2 of
+ *  the License, or (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "charactererrormap.h"
+
+namespace
+{
+    const int pageSize = 256;
+}
+
+CharacterErrorMap::CharacterErrorMap():
+    m_pages(pageSize)
+{
+}
+
+int CharacterErrorMap::errorCount(QChar character) const
+{
+    const QVector<int>& page = m_pages.at(character.row());
+    return page.isEmpty()? 0: page.at(character.cell());
+}
+
+int CharacterErrorMap::addError(QChar character)
+{
+    QVector<int>& page = m_pages[character.row()];
+
+    if (page.isEmpty())
+    {
+        page.fill(0, pageSize);
+    }
+
+    int& count = page[character.cell()];
+
+    if (count == 0)
+    {
+        m_characters.append(character);
+    }
+
+    return ++count;
+}
+
+void CharacterErrorMap::setErrorCount(QChar character, int errorCount)
+{
+    QVector<int>& page = m_pages[character.row()];
+
+    if (page.isEmpty())
+    {
+        if (errorCount == 0)
+            return;
+
+        page.fill(0, pageSize);
+    }
+
+    int& count = page[character.cell()];
+
+    if (count == 0 && errorCount != 0)
+    {
+        m_characters.append(character);
+    }
+    else if (count != 0 && errorCount == 0)
+    {
+        m_characters.removeOne(character);
+    }
+
+    count = errorCount;
+}
+
+int CharacterErrorMap::characterCount() const
+{
+    return m_characters.count();
+}
+
+QChar CharacterErrorMap::character(int index) const
+{
+    return m_characters.at(index);
+}
+
+bool CharacterErrorMap::isEmpty() const
+{
+    return m_characters.isEmpty();
+}
+
+void CharacterErrorMap::clear()
+{
+    // keep the pages, only the touched counters need to be reset
+    foreach (QChar character, m_characters)
+    {
+        m_pages[character.row()][character.cell()] = 0;
+    }
+
+    m_characters.clear();
+}
@@ -0,0 +1,48 @@
+/*
+ *  Copyright 2026  Sebastian Gottfried <sebastian.gottfried@posteo.de>
+ *
+ *  This program is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU General Public License as
+ *  published by the Free Software Foundation; either version 2 of
+ *  the License, or (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef CHARACTERERRORMAP_H
+#define CHARACTERERRORMAP_H
+
+#include <QChar>
+#include <QVector>
+
+/**
+ * Error counts per character, indexed directly by the UTF-16 code unit.
+ *
+ * The counters are kept in pages of 256 characters which are allocated the
+ * first time one of their characters gets an error, so counting an error is
+ * a plain array access afterwards. The characters with errors are
+ * additionally listed in the order of their first error.
+ */
+class CharacterErrorMap
+{
+public:
+    CharacterErrorMap();
+    int errorCount(QChar character) const;
+    int addError(QChar character);
+    void setErrorCount(QChar character, int errorCount);
+    int characterCount() const;
+    QChar character(int index) const;
+    bool isEmpty() const;
+    void clear();
+private:
+    QVector<QVector<int> > m_pages;
+    QVector<QChar> m_characters;
+};
+
+#endif // CHARACTERERRORMAP_H
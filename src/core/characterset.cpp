@@ -0,0 +1,182 @@
+/*
+ *  Copyright 2026  Sebastian Gottfried <sebastian.gottfried@posteo.de>
+ *
+ *  This program is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU General Public License as
+ *  published by the Free Software Foundation; either version 2 of
+ *  the License, or (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "characterset.h"
+
+#include <QtAlgorithms>
+
+namespace
+{
+    const int pageCount = 256;
+    const int wordsPerPage = 256 / 64;
+}
+
+CharacterSet::CharacterSet():
+    m_count(0)
+{
+}
+
+CharacterSet::CharacterSet(const QString& characters):
+    m_count(0)
+{
+    insert(characters);
+}
+
+bool CharacterSet::contains(uint codePoint) const
+{
+    if (codePoint > 0xffff)
+        return m_astralCodePoints.contains(codePoint);
+
+    if (m_pages.isEmpty())
+        return false;
+
+    const QVector<quint64>& page = m_pages.at(codePoint >> 8);
+    return !page.isEmpty() && (page.at((codePoint & 0xff) >> 6) & (quint64(1) << (codePoint & 0x3f)));
+}
+
+bool CharacterSet::contains(QChar character) const
+{
+    return contains(uint(character.unicode()));
+}
+
+bool CharacterSet::insert(uint codePoint)
+{
+    if (codePoint > 0xffff)
+    {
+        if (m_astralCodePoints.contains(codePoint))
+            return false;
+
+        m_astralCodePoints.insert(codePoint);
+        m_count++;
+        return true;
+    }
+
+    if (m_pages.isEmpty())
+    {
+        m_pages.resize(pageCount);
+    }
+
+    QVector<quint64>& page = m_pages[codePoint >> 8];
+
+    if (page.isEmpty())
+    {
+        page.fill(0, wordsPerPage);
+    }
+
+    quint64& word = page[(codePoint & 0xff) >> 6];
+    const quint64 bit = quint64(1) << (codePoint & 0x3f);
+
+    if (word & bit)
+        return false;
+
+    word |= bit;
+    m_count++;
+    return true;
+}
+
+void CharacterSet::insert(const QString& characters)
+{
+    for (int i = 0; i < characters.length();)
+    {
+        const uint codePoint = codePointAt(characters, i);
+        insert(codePoint);
+        i += QChar::requiresSurrogates(codePoint)? 2: 1;
+    }
+}
+
+CharacterSet& CharacterSet::unite(const CharacterSet& other)
+{
+    if (!other.m_pages.isEmpty())
+    {
+        if (m_pages.isEmpty())
+        {
+            m_pages.resize(pageCount);
+        }
+
+        for (int i = 0; i < pageCount; i++)
+        {
+            const QVector<quint64>& otherPage = other.m_pages.at(i);
+
+            if (otherPage.isEmpty())
+                continue;
+
+            if (m_pages.at(i).isEmpty())
+            {
+                m_pages[i] = otherPage;
+
+                foreach (quint64 word, otherPage)
+                {
+                    m_count += qPopulationCount(word);
+                }
+
+                continue;
+            }
+
+            QVector<quint64>& page = m_pages[i];
+
+            for (int j = 0; j < wordsPerPage; j++)
+            {
+                const quint64 newBits = otherPage.at(j) & ~page.at(j);
+                page[j] |= newBits;
+                m_count += qPopulationCount(newBits);
+            }
+        }
+    }
+
+    foreach (uint codePoint, other.m_astralCodePoints)
+    {
+        insert(codePoint);
+    }
+
+    return *this;
+}
+
+int CharacterSet::count() const
+{
+    return m_count;
+}
+
+bool CharacterSet::isEmpty() const
+{
+    return m_count == 0;
+}
+
+void CharacterSet::clear()
+{
+    m_pages.clear();
+    m_astralCodePoints.clear();
+    m_count = 0;
+}
+
+quint64 CharacterSet::bitmapWord(int index) const
+{
+    if (m_pages.isEmpty())
+        return 0;
+
+    const QVector<quint64>& page = m_pages.at(index / wordsPerPage);
+    return page.isEmpty()? 0: page.at(index % wordsPerPage);
+}
+
+uint CharacterSet::codePointAt(const QString& text, int index)
+{
+    const QChar character = text.at(index);
+
+    if (character.isHighSurrogate() && index + 1 < text.length() && text.at(index + 1).isLowSurrogate())
+        return QChar::surrogateToUcs4(character, text.at(index + 1));
+
+    return character.unicode();
+}
@@ -0,0 +1,66 @@
+/*
+ *  Copyright 2026  Sebastian Gottfried <sebastian.gottfried@posteo.de>
+ *
+ *  This program is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU General Public License as
+ *  published by the Free Software Foundation; either version 2 of
+ *  the License, or (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef CHARACTERSET_H
+#define CHARACTERSET_H
+
+#include <QChar>
+#include <QSet>
+#include <QString>
+#include <QVector>
+
+/**
+ * Set of Unicode code points with constant time membership tests.
+ *
+ * Code points of the basic multilingual plane are bits in pages of 256
+ * characters, which are allocated the first time one of their characters is
+ * inserted. The rare code points beyond are kept in a hash set. Strings are
+ * read as UTF-16, surrogate pairs count as one code point.
+ */
+class CharacterSet
+{
+public:
+    CharacterSet();
+    explicit CharacterSet(const QString& characters);
+    bool contains(uint codePoint) const;
+    bool contains(QChar character) const;
+    bool insert(uint codePoint);
+    void insert(const QString& characters);
+    CharacterSet& unite(const CharacterSet& other);
+    int count() const;
+    bool isEmpty() const;
+    void clear();
+
+    /**
+     * Returns the bits of the basic multilingual plane code points
+     * 64 * @p index to 64 * @p index + 63, for lookup tables.
+     */
+    quint64 bitmapWord(int index) const;
+
+    /**
+     * Returns the code point starting at @p index of @p text. Use
+     * QChar::requiresSurrogates() to find the start of the next one.
+     */
+    static uint codePointAt(const QString& text, int index);
+
+private:
+    QVector<QVector<quint64> > m_pages;
+    QSet<uint> m_astralCodePoints;
+    int m_count;
+};
+
+#endif // CHARACTERSET_H
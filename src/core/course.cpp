@@ -17,13 +17,16 @@
 
 #include "course.h"
 
+#include "characterset.h"
 #include "lesson.h"
 #include "dataindex.h"
+#include "textkernels.h"
 
 Course::Course(QObject *parent) :
     CourseBase(parent),
     m_associatedDataIndexCourse(0),
-    m_kind(Course::SequentialCourse)
+    m_kind(Course::SequentialCourse),
+    m_batchDepth(0)
 {
 }
 
@@ -108,12 +111,19 @@ Lesson* Course::lesson(int index) const
 
 void Course::addLesson(Lesson* lesson)
 {
+    if (m_batchDepth > 0)
+    {
+        m_lessons.append(lesson);
+        lesson->setParent(this);
+        connectLesson(lesson);
+        return;
+    }
+
     emit lessonAboutToBeAdded(lesson, m_lessons.length());
     m_lessons.append(lesson);
     lesson->setParent(this);
-    const int index = m_lessons.length() - 1;
-    updateLessonCharacters(index);
-    connect(lesson, &Lesson::newCharactersChanged, this, [=] { updateLessonCharacters(index); });
+    updateLessonCharacters(m_lessons.length() - 1);
+    connectLesson(lesson);
     emit lessonCountChanged();
     emit lessonAdded();
 }
@@ -121,11 +131,20 @@ void Course::addLesson(Lesson* lesson)
 void Course::insertLesson(int index, Lesson* lesson)
 {
     Q_ASSERT(index >= 0 && index < m_lessons.count());
+
+    if (m_batchDepth > 0)
+    {
+        m_lessons.insert(index, lesson);
+        lesson->setParent(this);
+        connectLesson(lesson);
+        return;
+    }
+
     emit lessonAboutToBeAdded(lesson, index);
     m_lessons.insert(index, lesson);
     lesson->setParent(this);
     updateLessonCharacters(index);
-    connect(lesson, &Lesson::newCharactersChanged, this, [=] { updateLessonCharacters(index); });
+    connectLesson(lesson);
     emit lessonCountChanged();
     emit lessonAdded();
 }
@@ -133,6 +152,13 @@ void Course::insertLesson(int index, Lesson* lesson)
 void Course::removeLesson(int index)
 {
     Q_ASSERT(index >= 0 && index < m_lessons.count());
+
+    if (m_batchDepth > 0)
+    {
+        delete m_lessons.takeAt(index);
+        return;
+    }
+
     emit lessonsAboutToBeRemoved(index, index);
     Lesson* const lesson = m_lessons.at(index);
     m_lessons.removeAt(index);
@@ -152,6 +178,13 @@ void Course::clearLessons()
     if (m_lessons.isEmpty())
         return;
 
+    if (m_batchDepth > 0)
+    {
+        qDeleteAll(m_lessons);
+        m_lessons.clear();
+        return;
+    }
+
     emit lessonsAboutToBeRemoved(0, m_lessons.length() - 1);
     qDeleteAll(m_lessons);
     m_lessons.clear();
@@ -159,6 +192,26 @@ void Course::clearLessons()
     emit lessonsRemoved();
 }
 
+void Course::beginBatch()
+{
+    if (m_batchDepth++ == 0)
+    {
+        emit lessonsAboutToBeReset();
+    }
+}
+
+void Course::endBatch()
+{
+    Q_ASSERT(m_batchDepth > 0);
+
+    if (--m_batchDepth > 0)
+        return;
+
+    updateLessonCharacters();
+    emit lessonCountChanged();
+    emit lessonsReset();
+}
+
 void Course::copyFrom(Course* source)
 {
     setIsValid(false);
@@ -167,6 +220,7 @@ void Course::copyFrom(Course* source)
     setDescription(source->description());
     setKeyboardLayoutName(source->keyboardLayoutName());
     setKind(source->kind());
+    beginBatch();
     clearLessons();
     for (int i = 0; i < source->lessonCount(); i++)
     {
@@ -174,28 +228,31 @@ void Course::copyFrom(Course* source)
         lesson->copyFrom(source->lesson(i));
         addLesson(lesson);
     }
+    endBatch();
     setIsValid(true);
 }
 
+void Course::connectLesson(Lesson* lesson)
+{
+    // the index of the lesson changes when lessons are inserted or removed before it
+    connect(lesson, &Lesson::newCharactersChanged, this, [=] { updateLessonCharacters(m_lessons.indexOf(lesson)); });
+}
+
 void Course::updateLessonCharacters(int firstIndex)
 {
-    if (m_kind == Course::LessonCollection)
+    if (m_kind == Course::LessonCollection || m_batchDepth > 0)
     {
         return;
     }
 
     QString characters = firstIndex > 0? lesson(firstIndex - 1)->characters(): QLatin1String("");
+    CharacterSet characterSet = firstIndex > 0? lesson(firstIndex - 1)->characterSet(): CharacterSet();
 
     for (int i = firstIndex; i < lessonCount(); i++)
     {
         Lesson* const lesson = this->lesson(i);
         const QString newChars = lesson->newCharacters();
-        for (int j = 0; j < newChars.length(); j++)
-        {
-            const QChar newChar = newChars.at(j);
-            if (!characters.contains(newChar))
-                characters.append(newChar);
-        }
+        TextKernels::collectDistinct(newChars.constData(), newChars.length(), characterSet, characters);
         lesson->setCharacters(characters);
     }
 }
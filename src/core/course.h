@@ -57,6 +57,15 @@ public:
     Q_INVOKABLE int indexOfLesson(Lesson* lesson);
     Q_INVOKABLE void clearLessons();
     Q_INVOKABLE void copyFrom(Course* source);
+    /**
+     * Batches lesson changes, for example while loading a course. Emits
+     * lessonsAboutToBeReset() right away and suppresses the per lesson
+     * signals until the matching endBatch(), which updates the lesson
+     * characters in one pass and emits lessonsReset(). Batches can be
+     * nested.
+     */
+    void beginBatch();
+    void endBatch();
 
 signals:
     void associatedDataIndexCourseChanged();
@@ -66,15 +75,19 @@ signals:
     void lessonAdded();
     void lessonsAboutToBeRemoved(int first, int last);
     void lessonsRemoved();
+    void lessonsAboutToBeReset();
+    void lessonsReset();
 
 private slots:
     void updateLessonCharacters(int firstIndex = 0);
 
 private:
     Q_DISABLE_COPY(Course)
+    void connectLesson(Lesson* lesson);
     DataIndexCourse* m_associatedDataIndexCourse;
     Kind m_kind;
     QList<Lesson*> m_lessons;
+    int m_batchDepth;
 };
 
 #endif // COURSE_H
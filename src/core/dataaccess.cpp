@@ -17,13 +17,20 @@
 
 #include "dataaccess.h"
 
+#include "core/course.h"
 #include "core/dataindex.h"
+#include "core/keyboardlayout.h"
+#include "core/keyboardlayoutdata.h"
+#include "core/resourcecache.h"
 #include "core/resourcedataaccess.h"
 #include "core/userdataaccess.h"
 
 DataAccess::DataAccess(QObject* parent) :
     QObject(parent)
 {
+    ResourceCache* const cache = ResourceCache::instance();
+    connect(cache, &ResourceCache::courseAvailable, this, &DataAccess::onCourseAvailable);
+    connect(cache, &ResourceCache::keyboardLayoutAvailable, this, &DataAccess::onKeyboardLayoutAvailable);
 }
 
 bool DataAccess::loadDataIndex(DataIndex* target)
@@ -44,13 +51,14 @@ bool DataAccess::loadDataIndex(DataIndex* target)
 
 bool DataAccess::loadCourse(DataIndexCourse* dataIndexCourse, Course* target)
 {
-    ResourceDataAccess resourceDataAccess;
     UserDataAccess userDataAccess;
 
+    cancelLoad(target);
+
     switch (dataIndexCourse->source())
     {
     case DataIndex::BuiltInResource:
-        return resourceDataAccess.loadCourse(dataIndexCourse->path(), target);
+        return ResourceCache::instance()->loadCourse(dataIndexCourse->path(), target);
     case DataIndex::UserResource:
         return userDataAccess.loadCourse(dataIndexCourse->id(), target);
     default:
@@ -60,16 +68,132 @@ bool DataAccess::loadCourse(DataIndexCourse* dataIndexCourse, Course* target)
 
 bool DataAccess::loadKeyboardLayout(DataIndexKeyboardLayout* dataIndexKeyboardLayout, KeyboardLayout* target)
 {
-    ResourceDataAccess resourceDataAccess;
     UserDataAccess userDataAccess;
 
+    cancelLoad(target);
+
     switch (dataIndexKeyboardLayout->source())
     {
     case DataIndex::BuiltInResource:
-        return resourceDataAccess.loadKeyboardLayout(dataIndexKeyboardLayout->path(), target);
+        return ResourceCache::instance()->loadKeyboardLayout(dataIndexKeyboardLayout->path(), target);
     case DataIndex::UserResource:
         return userDataAccess.loadKeyboardLayout(dataIndexKeyboardLayout->id(), target);
     default:
         return true;
     }
 }
+
+void DataAccess::loadCourseAsync(DataIndexCourse* dataIndexCourse, Course* target)
+{
+    ResourceCache* const cache = ResourceCache::instance();
+
+    // user resources live in the local database and are cheap to load
+    if (dataIndexCourse->source() != DataIndex::BuiltInResource || cache->course(dataIndexCourse->path()))
+    {
+        emit courseLoaded(target, loadCourse(dataIndexCourse, target));
+        return;
+    }
+
+    target->setIsValid(false);
+    setPendingPath(target, dataIndexCourse->path());
+    cache->requestCourse(dataIndexCourse->path());
+}
+
+void DataAccess::loadKeyboardLayoutAsync(DataIndexKeyboardLayout* dataIndexKeyboardLayout, KeyboardLayout* target)
+{
+    ResourceCache* const cache = ResourceCache::instance();
+
+    if (dataIndexKeyboardLayout->source() != DataIndex::BuiltInResource || cache->keyboardLayout(dataIndexKeyboardLayout->path()))
+    {
+        emit keyboardLayoutLoaded(target, loadKeyboardLayout(dataIndexKeyboardLayout, target));
+        return;
+    }
+
+    target->setIsValid(false);
+    setPendingPath(target, dataIndexKeyboardLayout->path());
+    cache->requestKeyboardLayout(dataIndexKeyboardLayout->path());
+}
+
+void DataAccess::prefetchCourse(DataIndexCourse* dataIndexCourse)
+{
+    if (!dataIndexCourse || dataIndexCourse->source() != DataIndex::BuiltInResource)
+        return;
+
+    ResourceCache::instance()->requestCourse(dataIndexCourse->path());
+}
+
+void DataAccess::cancelLoad(QObject* target)
+{
+    // for targets which get filled from elsewhere, like the custom lessons
+    setPendingPath(target, QString());
+}
+
+void DataAccess::onTargetDestroyed(QObject* target)
+{
+    m_pendingPaths.remove(target);
+}
+
+void DataAccess::onCourseAvailable(const QString& path, Course* course)
+{
+    // copy the list, the handlers of courseLoaded() might request new loads
+    const QList<QObject*> targets = m_pendingPaths.keys(path);
+
+    foreach (QObject* object, targets)
+    {
+        Course* const target = qobject_cast<Course*>(object);
+
+        if (!target)
+            continue;
+
+        setPendingPath(target, QString());
+
+        if (course)
+        {
+            target->copyFrom(course);
+        }
+
+        emit courseLoaded(target, course != 0);
+    }
+}
+
+void DataAccess::onKeyboardLayoutAvailable(const QString& path, const KeyboardLayoutData* keyboardLayout)
+{
+    const QList<QObject*> targets = m_pendingPaths.keys(path);
+
+    foreach (QObject* object, targets)
+    {
+        KeyboardLayout* const target = qobject_cast<KeyboardLayout*>(object);
+
+        if (!target)
+            continue;
+
+        setPendingPath(target, QString());
+
+        if (keyboardLayout)
+        {
+            keyboardLayout->applyTo(target);
+        }
+
+        emit keyboardLayoutLoaded(target, keyboardLayout != 0);
+    }
+}
+
+void DataAccess::setPendingPath(QObject* target, const QString& path)
+{
+    // only the result of the latest request for a target gets delivered
+    if (path.isNull())
+    {
+        if (m_pendingPaths.remove(target))
+        {
+            disconnect(target, &QObject::destroyed, this, &DataAccess::onTargetDestroyed);
+        }
+        return;
+    }
+
+    if (!m_pendingPaths.contains(target))
+    {
+        connect(target, &QObject::destroyed, this, &DataAccess::onTargetDestroyed);
+    }
+
+    m_pendingPaths.insert(target, path);
+}
@@ -18,6 +18,7 @@
 #ifndef DATAACCESS_H
 #define DATAACCESS_H
 
+#include <QHash>
 #include <QObject>
 
 class Course;
@@ -25,6 +26,7 @@ class DataIndex;
 class DataIndexCourse;
 class DataIndexKeyboardLayout;
 class KeyboardLayout;
+struct KeyboardLayoutData;
 
 class DataAccess : public QObject
 {
@@ -34,6 +36,23 @@ public:
     Q_INVOKABLE bool loadDataIndex(DataIndex* target);
     Q_INVOKABLE bool loadCourse(DataIndexCourse* dataIndexCourse, Course* target);
     Q_INVOKABLE bool loadKeyboardLayout(DataIndexKeyboardLayout* dataIndexKeyboardLayout, KeyboardLayout* target);
+    Q_INVOKABLE void loadCourseAsync(DataIndexCourse* dataIndexCourse, Course* target);
+    Q_INVOKABLE void loadKeyboardLayoutAsync(DataIndexKeyboardLayout* dataIndexKeyboardLayout, KeyboardLayout* target);
+    Q_INVOKABLE void prefetchCourse(DataIndexCourse* dataIndexCourse);
+    Q_INVOKABLE void cancelLoad(QObject* target);
+
+signals:
+    void courseLoaded(Course* course, bool success);
+    void keyboardLayoutLoaded(KeyboardLayout* keyboardLayout, bool success);
+
+private slots:
+    void onTargetDestroyed(QObject* target);
+
+private:
+    void onCourseAvailable(const QString& path, Course* course);
+    void onKeyboardLayoutAvailable(const QString& path, const KeyboardLayoutData* keyboardLayout);
+    void setPendingPath(QObject* target, const QString& path);
+    QHash<QObject*, QString> m_pendingPaths;
 };
 
 #endif // DATAACCESS_H
@@ -0,0 +1,329 @@
+/*
+ *  Copyright 2026  Sebastian Gottfried <sebastian.gottfried@posteo.de>
+ *
+ *  This program is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU General Public License as
+ *  published by the Free Software Foundation; either version 2 of
+ *  the License, or (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "dataindexwatcher.h"
+
+#include <QDebug>
+#include <QDir>
+#include <QFileInfo>
+#include <QFileSystemWatcher>
+#include <QFutureWatcher>
+#include <QHash>
+#include <QStandardPaths>
+#include <QThread>
+#include <QTimer>
+#include <QtConcurrent>
+
+#include "resourcedataaccess.h"
+#include "userdataaccess.h"
+
+namespace
+{
+    // files are usually written in bursts, wait for them to settle
+    const int refreshDelay = 500;
+}
+
+DataIndexWatcher::DataIndexWatcher(DataIndex* dataIndex, QObject* parent):
+    QObject(parent),
+    m_dataIndex(dataIndex),
+    m_watcher(new QFileSystemWatcher(this)),
+    m_builtInRefreshTimer(new QTimer(this)),
+    m_userRefreshTimer(new QTimer(this)),
+    m_builtInRefreshWatcher(new QFutureWatcher<DataIndex*>(this)),
+    m_userRefreshWatcher(new QFutureWatcher<DataIndex*>(this)),
+    m_builtInRefreshQueued(false),
+    m_userRefreshQueued(false),
+    m_dbPath(QDir(QStandardPaths::writableLocation(QStandardPaths::DataLocation)).filePath(QStringLiteral("profiles.db")))
+{
+    m_builtInRefreshTimer->setSingleShot(true);
+    m_builtInRefreshTimer->setInterval(refreshDelay);
+    m_userRefreshTimer->setSingleShot(true);
+    m_userRefreshTimer->setInterval(refreshDelay);
+
+    connect(m_builtInRefreshTimer, &QTimer::timeout, this, &DataIndexWatcher::refreshBuiltInResources);
+    connect(m_userRefreshTimer, &QTimer::timeout, this, &DataIndexWatcher::refreshUserResources);
+    connect(m_watcher, &QFileSystemWatcher::directoryChanged, this, &DataIndexWatcher::onDirectoryChanged);
+    connect(m_watcher, &QFileSystemWatcher::fileChanged, this, &DataIndexWatcher::onFileChanged);
+    connect(m_builtInRefreshWatcher, &QFutureWatcherBase::finished, this, &DataIndexWatcher::onBuiltInResourcesLoaded);
+    connect(m_userRefreshWatcher, &QFutureWatcherBase::finished, this, &DataIndexWatcher::onUserResourcesLoaded);
+
+    updateWatchedPaths();
+}
+
+void DataIndexWatcher::onDirectoryChanged()
+{
+    // the database creates and removes its journal next to it all the time,
+    // so only react if the set of watched files has actually changed
+    const QStringList watchedFiles = m_watcher->files();
+
+    updateWatchedPaths();
+
+    const QStringList files = m_watcher->files();
+
+    if (files == watchedFiles)
+        return;
+
+    if (files.contains(m_dbPath) != watchedFiles.contains(m_dbPath))
+    {
+        m_userRefreshTimer->start();
+    }
+
+    m_builtInRefreshTimer->start();
+}
+
+void DataIndexWatcher::onFileChanged(const QString& path)
+{
+    if (path == m_dbPath)
+    {
+        m_userRefreshTimer->start();
+    }
+    else
+    {
+        m_builtInRefreshTimer->start();
+    }
+
+    // files replaced by renaming them are dropped by the watcher
+    updateWatchedPaths();
+}
+
+void DataIndexWatcher::updateWatchedPaths()
+{
+    QStringList paths;
+
+    foreach (const QString& location, QStandardPaths::standardLocations(QStandardPaths::DataLocation))
+    {
+        const QDir dir(location);
+
+        if (!dir.exists())
+            continue;
+
+        paths.append(dir.path());
+
+        const QString dataIndexPath = dir.filePath(QStringLiteral("data.xml"));
+
+        if (QFileInfo::exists(dataIndexPath))
+        {
+            paths.append(dataIndexPath);
+        }
+    }
+
+    if (QFileInfo::exists(m_dbPath))
+    {
+        paths.append(m_dbPath);
+    }
+
+    for (int i = 0; i < m_dataIndex->courseCount(); i++)
+    {
+        DataIndexCourse* const course = m_dataIndex->course(i);
+
+        if (course->source() == DataIndex::BuiltInResource && QFileInfo::exists(course->path()))
+        {
+            paths.append(course->path());
+        }
+    }
+
+    for (int i = 0; i < m_dataIndex->keyboardLayoutCount(); i++)
+    {
+        DataIndexKeyboardLayout* const keyboardLayout = m_dataIndex->keyboardLayout(i);
+
+        if (keyboardLayout->source() == DataIndex::BuiltInResource && QFileInfo::exists(keyboardLayout->path()))
+        {
+            paths.append(keyboardLayout->path());
+        }
+    }
+
+    const QStringList watchedPaths = m_watcher->files() + m_watcher->directories();
+    QStringList removedPaths;
+    QStringList addedPaths;
+
+    foreach (const QString& path, watchedPaths)
+    {
+        if (!paths.contains(path))
+        {
+            removedPaths.append(path);
+        }
+    }
+
+    foreach (const QString& path, paths)
+    {
+        if (!watchedPaths.contains(path))
+        {
+            addedPaths.append(path);
+        }
+    }
+
+    if (!removedPaths.isEmpty())
+    {
+        m_watcher->removePaths(removedPaths);
+    }
+
+    if (!addedPaths.isEmpty())
+    {
+        m_watcher->addPaths(addedPaths);
+    }
+}
+
+void DataIndexWatcher::refreshBuiltInResources()
+{
+    // changes during a refresh might have been missed by it, so do another one afterwards
+    if (m_builtInRefreshWatcher->isRunning())
+    {
+        m_builtInRefreshQueued = true;
+        return;
+    }
+
+    m_builtInRefreshWatcher->setFuture(QtConcurrent::run(ResourceDataAccess::loadDataIndex, thread()));
+}
+
+void DataIndexWatcher::refreshUserResources()
+{
+    if (m_userRefreshWatcher->isRunning())
+    {
+        m_userRefreshQueued = true;
+        return;
+    }
+
+    m_userRefreshWatcher->setFuture(QtConcurrent::run(UserDataAccess::loadDataIndex, thread()));
+}
+
+void DataIndexWatcher::onBuiltInResourcesLoaded()
+{
+    DataIndex* const freshIndex = m_builtInRefreshWatcher->result();
+
+    if (freshIndex->isValid())
+    {
+        applyChanges(freshIndex, DataIndex::BuiltInResource);
+        updateWatchedPaths();
+    }
+    else
+    {
+        qWarning() << "can't refresh the built-in resources, keeping the current ones";
+    }
+
+    delete freshIndex;
+
+    if (m_builtInRefreshQueued)
+    {
+        m_builtInRefreshQueued = false;
+        refreshBuiltInResources();
+    }
+}
+
+void DataIndexWatcher::onUserResourcesLoaded()
+{
+    DataIndex* const freshIndex = m_userRefreshWatcher->result();
+
+    if (freshIndex->isValid())
+    {
+        applyChanges(freshIndex, DataIndex::UserResource);
+    }
+    else
+    {
+        qWarning() << "can't refresh the user resources, keeping the current ones";
+    }
+
+    delete freshIndex;
+
+    if (m_userRefreshQueued)
+    {
+        m_userRefreshQueued = false;
+        refreshUserResources();
+    }
+}
+
+void DataIndexWatcher::applyChanges(DataIndex* freshIndex, DataIndex::Source source)
+{
+    QHash<QString, DataIndexCourse*> freshCourses;
+
+    for (int i = 0; i < freshIndex->courseCount(); i++)
+    {
+        DataIndexCourse* const course = freshIndex->course(i);
+        freshCourses.insert(course->id(), course);
+    }
+
+    for (int i = m_dataIndex->courseCount() - 1; i >= 0; i--)
+    {
+        DataIndexCourse* const course = m_dataIndex->course(i);
+
+        if (course->source() != source)
+            continue;
+
+        DataIndexCourse* const freshCourse = freshCourses.take(course->id());
+
+        if (!freshCourse)
+        {
+            m_dataIndex->removeCourse(i);
+            continue;
+        }
+
+        course->setTitle(freshCourse->title());
+        course->setDescription(freshCourse->description());
+        course->setKeyboardLayoutName(freshCourse->keyboardLayoutName());
+        course->setPath(freshCourse->path());
+        course->setIsValid(freshCourse->isValid());
+    }
+
+    // add the new ones in the order of the fresh index
+    for (int i = 0; i < freshIndex->courseCount(); i++)
+    {
+        DataIndexCourse* const course = freshIndex->course(i);
+
+        if (freshCourses.value(course->id()) == course)
+        {
+            m_dataIndex->addCourse(course);
+        }
+    }
+
+    QHash<QString, DataIndexKeyboardLayout*> freshKeyboardLayouts;
+
+    for (int i = 0; i < freshIndex->keyboardLayoutCount(); i++)
+    {
+        DataIndexKeyboardLayout* const keyboardLayout = freshIndex->keyboardLayout(i);
+        freshKeyboardLayouts.insert(keyboardLayout->id(), keyboardLayout);
+    }
+
+    for (int i = m_dataIndex->keyboardLayoutCount() - 1; i >= 0; i--)
+    {
+        DataIndexKeyboardLayout* const keyboardLayout = m_dataIndex->keyboardLayout(i);
+
+        if (keyboardLayout->source() != source)
+            continue;
+
+        DataIndexKeyboardLayout* const freshKeyboardLayout = freshKeyboardLayouts.take(keyboardLayout->id());
+
+        if (!freshKeyboardLayout)
+        {
+            m_dataIndex->removeKeyboardLayout(i);
+            continue;
+        }
+
+        keyboardLayout->setTitle(freshKeyboardLayout->title());
+        keyboardLayout->setName(freshKeyboardLayout->name());
+        keyboardLayout->setPath(freshKeyboardLayout->path());
+        keyboardLayout->setIsValid(freshKeyboardLayout->isValid());
+    }
+
+    for (int i = 0; i < freshIndex->keyboardLayoutCount(); i++)
+    {
+        DataIndexKeyboardLayout* const keyboardLayout = freshIndex->keyboardLayout(i);
+
+        if (freshKeyboardLayouts.value(keyboardLayout->id()) == keyboardLayout)
+        {
+            m_dataIndex->addKeyboardLayout(keyboardLayout);
+        }
+    }
+}
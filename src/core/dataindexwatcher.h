@@ -0,0 +1,66 @@
+/*
+ *  Copyright 2026  Sebastian Gottfried <sebastian.gottfried@posteo.de>
+ *
+ *  This program is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU General Public License as
+ *  published by the Free Software Foundation; either version 2 of
+ *  the License, or (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef DATAINDEXWATCHER_H
+#define DATAINDEXWATCHER_H
+
+#include <QObject>
+
+#include "dataindex.h"
+
+class QFileSystemWatcher;
+class QTimer;
+template <typename T> class QFutureWatcher;
+
+/**
+ * Watches the data locations and the user database and keeps a data index
+ * up to date with them. Changes are applied as individual additions,
+ * removals and property updates, so models built on top of the index don't
+ * have to be reset.
+ *
+ * Besides the locations and the data index files, the files of the built-in
+ * resources in the index are watched, so fixing a broken course updates its
+ * valid flag. The fresh indexes are read and validated on the global thread
+ * pool, only the changes are applied on the GUI thread.
+ */
+class DataIndexWatcher : public QObject
+{
+    Q_OBJECT
+public:
+    explicit DataIndexWatcher(DataIndex* dataIndex, QObject* parent = 0);
+
+private:
+    void onDirectoryChanged();
+    void onFileChanged(const QString& path);
+    void updateWatchedPaths();
+    void refreshBuiltInResources();
+    void refreshUserResources();
+    void onBuiltInResourcesLoaded();
+    void onUserResourcesLoaded();
+    void applyChanges(DataIndex* freshIndex, DataIndex::Source source);
+    DataIndex* m_dataIndex;
+    QFileSystemWatcher* m_watcher;
+    QTimer* m_builtInRefreshTimer;
+    QTimer* m_userRefreshTimer;
+    QFutureWatcher<DataIndex*>* m_builtInRefreshWatcher;
+    QFutureWatcher<DataIndex*>* m_userRefreshWatcher;
+    bool m_builtInRefreshQueued;
+    bool m_userRefreshQueued;
+    QString m_dbPath;
+};
+
+#endif // DATAINDEXWATCHER_H
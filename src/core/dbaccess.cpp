@@ -18,7 +18,9 @@
 #include "dbaccess.h"
 
 #include <QDebug>
+#include <QCoreApplication>
 #include <QDir>
+#include <QThread>
 #include <QUuid>
 #include <QSqlDatabase>
 #include <QSqlQuery>
@@ -39,9 +41,16 @@ QString DbAccess::errorMessage() const
     return m_errorMessage;
 }
 
+bool DbAccess::openDatabase()
+{
+    return database().isOpen();
+}
+
 QSqlDatabase DbAccess::database()
 {
-    if (!QSqlDatabase::contains(QSqlDatabase::defaultConnection))
+    const QString name = connectionName();
+
+    if (!QSqlDatabase::contains(name))
     {
         QDir dataDir = QDir(QStandardPaths::writableLocation(QStandardPaths::DataLocation));
         if (!dataDir.exists())
@@ -49,7 +58,7 @@ QSqlDatabase DbAccess::database()
             dataDir.mkpath(dataDir.path());
         }
         QString dbPath = dataDir.filePath(QStringLiteral("profiles.db"));
-        QSqlDatabase db = QSqlDatabase::addDatabase(QStringLiteral("QSQLITE"));
+        QSqlDatabase db = QSqlDatabase::addDatabase(QStringLiteral("QSQLITE"), name);
         db.setDatabaseName(dbPath);
         if (!db.open())
         {
@@ -58,7 +67,7 @@ QSqlDatabase DbAccess::database()
             return db;
         }
 
-        if (!checkDbSchema())
+        if (!checkDbSchema(db))
         {
             db.close();
         }
@@ -66,7 +75,30 @@ QSqlDatabase DbAccess::database()
         return db;
     }
 
-    return QSqlDatabase::database(QSqlDatabase::defaultConnection);
+    return QSqlDatabase::database(name);
+}
+
+void DbAccess::releaseThreadDatabase()
+{
+    const QString name = connectionName();
+
+    if (name == QLatin1String(QSqlDatabase::defaultConnection) || !QSqlDatabase::contains(name))
+        return;
+
+    QSqlDatabase::database(name, false).close();
+    QSqlDatabase::removeDatabase(name);
+}
+
+QString DbAccess::connectionName()
+{
+    // connections can only be used from the thread which created them,
+    // so worker threads get a private one
+    QThread* const thread = QThread::currentThread();
+
+    if (thread == QCoreApplication::instance()->thread())
+        return QLatin1String(QSqlDatabase::defaultConnection);
+
+    return QStringLiteral("ktouch-worker-%1").arg(reinterpret_cast<quintptr>(thread));
 }
 
 void DbAccess::raiseError(const QSqlError& error)
@@ -75,10 +107,8 @@ void DbAccess::raiseError(const QSqlError& error)
     emit errorMessageChanged();
 }
 
-bool DbAccess::checkDbSchema()
+bool DbAccess::checkDbSchema(QSqlDatabase& db)
 {
-    QSqlDatabase db = QSqlDatabase::database();
-
     db.exec("CREATE TABLE IF NOT EXISTS metadata ("
             "key TEXT PRIMARY KEY, "
             "value TEXT"
@@ -108,7 +138,7 @@ bool DbAccess::checkDbSchema()
 
         if (version == QLatin1String("1.0"))
         {
-            return migrateFrom1_0To1_1();
+            return migrateFrom1_0To1_1(db);
         }
 
         if (version != QLatin1String("1.1"))
@@ -301,10 +331,8 @@ bool DbAccess::checkDbSchema()
     return true;
 }
 
-bool DbAccess::migrateFrom1_0To1_1()
+bool DbAccess::migrateFrom1_0To1_1(QSqlDatabase& db)
 {
-    QSqlDatabase db = QSqlDatabase::database();
-
     if (!db.transaction())
     {
         qWarning() <<  db.lastError().text();
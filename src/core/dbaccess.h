@@ -30,6 +30,8 @@ class DbAccess : public QObject
 public:
     explicit DbAccess(QObject* parent = 0);
     QString errorMessage() const;
+    bool openDatabase();
+    static void releaseThreadDatabase();
 
 signals:
     void errorMessageChanged();
@@ -38,8 +40,9 @@ protected:
     QSqlDatabase database();
     void raiseError(const QSqlError& error);
 private:
-    bool checkDbSchema();
-    bool migrateFrom1_0To1_1();
+    static QString connectionName();
+    bool checkDbSchema(QSqlDatabase& db);
+    bool migrateFrom1_0To1_1(QSqlDatabase& db);
     QString m_errorMessage;
 };
 
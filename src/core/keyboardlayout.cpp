@@ -31,6 +31,31 @@
 #include "keychar.h"
 #include "specialkey.h"
 #include "dataindex.h"
+#include "keyboardlayoutdata.h"
+
+namespace
+{
+    int specialKeyCode(SpecialKey::Type type)
+    {
+        switch (type)
+        {
+        case SpecialKey::Tab:
+            return Qt::Key_Tab;
+        case SpecialKey::Capslock:
+            return Qt::Key_CapsLock;
+        case SpecialKey::Shift:
+            return Qt::Key_Shift;
+        case SpecialKey::Backspace:
+            return Qt::Key_Backspace;
+        case SpecialKey::Return:
+            return Qt::Key_Return;
+        case SpecialKey::Space:
+            return Qt::Key_Space;
+        default:
+            return -1;
+        }
+    }
+}
 
 KeyboardLayout::KeyboardLayout(QObject *parent) :
     KeyboardLayoutBase(parent),
@@ -40,7 +65,9 @@ KeyboardLayout::KeyboardLayout(QObject *parent) :
     m_width(0),
     m_height(0),
     m_keys(QList<AbstractKey*>()),
-    m_referenceKey(0)
+    m_referenceKey(0),
+    m_batchDepth(0),
+    m_keyIndexDirty(true)
 {
 }
 
@@ -128,53 +155,66 @@ AbstractKey* KeyboardLayout::referenceKey()
 
 void KeyboardLayout::copyFrom(KeyboardLayout* source)
 {
-    setIsValid(false);
-    setTitle(source->title());
-    setName(source->name());
-    setWidth(source->width());
-    setHeight(source->height());
-    clearKeys();
-    for(int i = 0; i < source->keyCount(); i++)
-    {
-        AbstractKey* const abstractSourceKey = source->key(i);
-        AbstractKey* abstractKey = 0;
+    KeyboardLayoutData::fromKeyboardLayout(source).applyTo(this);
+}
 
-        Key* const sourceKey = qobject_cast<Key*>(abstractSourceKey);
-        if (sourceKey)
+QString KeyboardLayout::allCharacters() const
+{
+    updateKeyIndex();
+    return m_allCharacters;
+}
+
+const CharacterSet& KeyboardLayout::characterSet() const
+{
+    updateKeyIndex();
+    return m_characterSet;
+}
+
+QList<int> KeyboardLayout::findKeyIndexes(const QString& text, int keyCode) const
+{
+    updateKeyIndex();
+
+    QList<int> result;
+
+    if (text.length() == 1)
+    {
+        foreach (const CharacterKey& characterKey, m_characterKeys.value(text.at(0)))
         {
-            Key* key = new Key(this);
-            key->copyFrom(sourceKey);
-            abstractKey = key;
+            result.append(characterKey.keyIndex);
         }
+    }
 
-        SpecialKey* const sourceSpecialKey = qobject_cast<SpecialKey*>(abstractSourceKey);
-        if (sourceSpecialKey)
+    foreach (int keyIndex, m_keyCodeKeys.value(keyCode))
+    {
+        if (!result.contains(keyIndex))
         {
-            SpecialKey* specialKey = new SpecialKey(this);
-            specialKey->copyFrom(sourceSpecialKey);
-            abstractKey = specialKey;
+            result.append(keyIndex);
         }
-
-        addKey(abstractKey);
     }
-    setIsValid(true);
+
+    return result;
 }
 
-QString KeyboardLayout::allCharacters() const
+QString KeyboardLayout::modifierIdForCharacter(const QString& character, int keyIndex) const
 {
-    QString result;
-    for (const auto abstractKey: m_keys)
+    if (character.length() != 1)
+        return QString();
+
+    updateKeyIndex();
+
+    foreach (const CharacterKey& characterKey, m_characterKeys.value(character.at(0)))
     {
-        Key* const key = qobject_cast<Key*>(abstractKey);
-        if (key)
-        {
-            for (const auto keyChar : key->keyChars())
-            {
-                result.append(keyChar->value());
-            }
-        }
+        if (characterKey.keyIndex == keyIndex)
+            return characterKey.modifierId;
     }
-    return result;
+
+    return QString();
+}
+
+int KeyboardLayout::modifierKeyIndex(const QString& modifierId) const
+{
+    updateKeyIndex();
+    return m_modifierKeys.value(modifierId, -1);
 }
 
 AbstractKey* KeyboardLayout::key(int index) const
@@ -190,20 +230,20 @@ int KeyboardLayout::keyIndex(AbstractKey* key) const
 
 void KeyboardLayout::addKey(AbstractKey* key)
 {
-    m_keys.append(key);
-    key->setParent(this);
-    connect(key, &AbstractKey::widthChanged, this, [=] { onKeyGeometryChanged(m_keys.count() - 1); } );
-    connect(key, &AbstractKey::heightChanged, this, [=] { onKeyGeometryChanged(m_keys.count() - 1); } );
-    emit keyCountChanged();
-    updateReferenceKey(key);
+    insertKey(m_keys.count(), key);
 }
 
 void KeyboardLayout::insertKey(int index, AbstractKey* key)
 {
     m_keys.insert(index, key);
     key->setParent(this);
-    connect(key, &AbstractKey::widthChanged, this, [=] { onKeyGeometryChanged(m_keys.count() - 1); } );
-    connect(key, &AbstractKey::heightChanged, this, [=] { onKeyGeometryChanged(m_keys.count() - 1); } );
+    connect(key, &AbstractKey::widthChanged, this, [=] { onKeyGeometryChanged(key); } );
+    connect(key, &AbstractKey::heightChanged, this, [=] { onKeyGeometryChanged(key); } );
+    connectKey(key);
+
+    if (m_batchDepth > 0)
+        return;
+
     emit keyCountChanged();
     updateReferenceKey(key);
 }
@@ -213,9 +253,19 @@ void KeyboardLayout::removeKey(int index)
     Q_ASSERT(index >= 0 && index < m_keys.count());
     AbstractKey* key = m_keys.at(index);
     m_keys.removeAt(index);
-    emit keyCountChanged();
-    updateReferenceKey(0);
+    key->disconnect(this);
+    invalidateKeyIndex();
     key->deleteLater();
+
+    if (m_batchDepth > 0)
+        return;
+
+    emit keyCountChanged();
+
+    if (key == m_referenceKey)
+    {
+        updateReferenceKey(0);
+    }
 }
 
 void KeyboardLayout::clearKeys()
@@ -225,6 +275,31 @@ void KeyboardLayout::clearKeys()
 
     qDeleteAll(m_keys);
     m_keys.clear();
+    invalidateKeyIndex();
+
+    if (m_batchDepth > 0)
+    {
+        // don't leave a dangling pointer until the batch ends
+        m_referenceKey = 0;
+        return;
+    }
+
+    emit keyCountChanged();
+    updateReferenceKey(0);
+}
+
+void KeyboardLayout::beginBatch()
+{
+    m_batchDepth++;
+}
+
+void KeyboardLayout::endBatch()
+{
+    Q_ASSERT(m_batchDepth > 0);
+
+    if (--m_batchDepth > 0)
+        return;
+
     emit keyCountChanged();
     updateReferenceKey(0);
 }
@@ -240,27 +315,113 @@ void KeyboardLayout::setSize(const QSize& size)
     setHeight(size.height());
 }
 
-void KeyboardLayout::onKeyGeometryChanged(int keyIndex)
+void KeyboardLayout::onKeyGeometryChanged(AbstractKey* key)
 {
-    updateReferenceKey(key(keyIndex));
+    if (m_batchDepth > 0)
+        return;
+
+    updateReferenceKey(key);
 }
 
-void KeyboardLayout::updateReferenceKey(AbstractKey *testKey)
+void KeyboardLayout::invalidateKeyIndex()
 {
-    if (testKey)
+    m_keyIndexDirty = true;
+}
+
+void KeyboardLayout::connectKey(AbstractKey* abstractKey)
+{
+    invalidateKeyIndex();
+
+    if (Key* const key = qobject_cast<Key*>(abstractKey))
     {
-        if (!m_referenceKey)
+        auto connectKeyChar = [=](KeyChar* keyChar) {
+            connect(keyChar, &KeyChar::valueChanged, this, &KeyboardLayout::invalidateKeyIndex);
+            connect(keyChar, &KeyChar::modifierChanged, this, &KeyboardLayout::invalidateKeyIndex);
+        };
+
+        foreach (KeyChar* keyChar, key->keyChars())
         {
-            m_referenceKey = testKey;
-            emit referenceKeyChanged();
-            return;
+            connectKeyChar(keyChar);
+        }
+
+        connect(key, &Key::keyCharAboutToBeAdded, this, connectKeyChar);
+        connect(key, &Key::keyCharAdded, this, &KeyboardLayout::invalidateKeyIndex);
+        connect(key, &Key::keyCharsRemoved, this, &KeyboardLayout::invalidateKeyIndex);
+    }
+    else if (SpecialKey* const specialKey = qobject_cast<SpecialKey*>(abstractKey))
+    {
+        connect(specialKey, &SpecialKey::typeChanged, this, &KeyboardLayout::invalidateKeyIndex);
+        connect(specialKey, &SpecialKey::modifierIdChanged, this, &KeyboardLayout::invalidateKeyIndex);
+    }
+}
+
+void KeyboardLayout::updateKeyIndex() const
+{
+    if (!m_keyIndexDirty)
+        return;
+
+    m_characterKeys.clear();
+    m_keyCodeKeys.clear();
+    m_modifierKeys.clear();
+    m_allCharacters.clear();
+    m_characterSet.clear();
+
+    for (int i = 0; i < m_keys.count(); i++)
+    {
+        AbstractKey* const abstractKey = m_keys.at(i);
+
+        if (Key* const key = qobject_cast<Key*>(abstractKey))
+        {
+            foreach (KeyChar* keyChar, key->keyChars())
+            {
+                m_allCharacters.append(keyChar->value());
+                m_characterSet.insert(keyChar->value().unicode());
+
+                QVector<CharacterKey>& characterKeys = m_characterKeys[keyChar->value()];
+
+                // a character can be on a key more than once, the first one wins
+                if (characterKeys.isEmpty() || characterKeys.last().keyIndex != i)
+                {
+                    characterKeys.append({i, keyChar->modifier()});
+                }
+            }
         }
-        if (compareKeysForReference(testKey, m_referenceKey))
+        else if (SpecialKey* const specialKey = qobject_cast<SpecialKey*>(abstractKey))
+        {
+            const int keyCode = specialKeyCode(specialKey->type());
+
+            if (keyCode != -1)
+            {
+                m_keyCodeKeys[keyCode].append(i);
+            }
+
+            if (specialKey->type() == SpecialKey::Space)
+            {
+                m_characterKeys[QLatin1Char(' ')].append({i, QString()});
+            }
+
+            if (!specialKey->modifierId().isEmpty() && !m_modifierKeys.contains(specialKey->modifierId()))
+            {
+                m_modifierKeys.insert(specialKey->modifierId(), i);
+            }
+        }
+    }
+
+    m_keyIndexDirty = false;
+}
+
+void KeyboardLayout::updateReferenceKey(AbstractKey *testKey)
+{
+    // any other key than the reference key can only take its place, only
+    // changes of the reference key itself need a full scan
+    if (testKey && testKey != m_referenceKey)
+    {
+        if (!m_referenceKey || compareKeysForReference(testKey, m_referenceKey))
         {
             m_referenceKey = testKey;
             emit referenceKeyChanged();
-            return;
         }
+        return;
     }
     AbstractKey* canditate = 0;
     foreach(AbstractKey* key, m_keys)
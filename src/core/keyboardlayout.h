@@ -19,9 +19,12 @@
 #define KEYBOARD_H
 
 #include "keyboardlayoutbase.h"
+#include "characterset.h"
 
+#include <QHash>
 #include <QString>
 #include <QVariant>
+#include <QVector>
 
 class AbstractKey;
 class DataIndexKeyboardLayout;
@@ -53,9 +56,22 @@ public:
     Q_INVOKABLE void insertKey(int index, AbstractKey* key);
     Q_INVOKABLE void removeKey(int index);
     Q_INVOKABLE void clearKeys();
+    /**
+     * Batches key changes, for example while loading a layout. Until the
+     * matching endBatch(), keyCountChanged() and referenceKeyChanged() are
+     * not emitted and the reference key is not maintained. endBatch()
+     * finds the reference key in one pass and emits both signals once.
+     * Batches can be nested.
+     */
+    void beginBatch();
+    void endBatch();
     AbstractKey* referenceKey();
     Q_INVOKABLE void copyFrom(KeyboardLayout* source);
     Q_INVOKABLE QString allCharacters() const;
+    const CharacterSet& characterSet() const;
+    Q_INVOKABLE QList<int> findKeyIndexes(const QString& text, int keyCode) const;
+    Q_INVOKABLE QString modifierIdForCharacter(const QString& character, int keyIndex) const;
+    Q_INVOKABLE int modifierKeyIndex(const QString& modifierId) const;
 
     QSize size() const;
     void setSize(const QSize& size);
@@ -68,9 +84,17 @@ signals:
     void keyCountChanged();
 
 private slots:
-    void onKeyGeometryChanged(int keyIndex);
+    void onKeyGeometryChanged(AbstractKey* key);
+    void invalidateKeyIndex();
 
 private:
+    struct CharacterKey
+    {
+        int keyIndex;
+        QString modifierId;
+    };
+    void connectKey(AbstractKey* key);
+    void updateKeyIndex() const;
     void updateReferenceKey(AbstractKey* newKey=0);
     bool compareKeysForReference(const AbstractKey* testKey, const AbstractKey* compareKey) const;
     DataIndexKeyboardLayout* m_associatedDataIndexKeyboardLayout;
@@ -80,6 +104,13 @@ private:
     int m_height;
     QList<AbstractKey*> m_keys;
     AbstractKey* m_referenceKey;
+    int m_batchDepth;
+    mutable bool m_keyIndexDirty;
+    mutable QHash<QChar, QVector<CharacterKey> > m_characterKeys;
+    mutable QHash<int, QVector<int> > m_keyCodeKeys;
+    mutable QHash<QString, int> m_modifierKeys;
+    mutable QString m_allCharacters;
+    mutable CharacterSet m_characterSet;
 
 };
 
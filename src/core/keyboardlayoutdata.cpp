@@ -0,0 +1,142 @@
+/*
+ *  Copyright 2026  Sebastian Gottfried <sebastian.gottfried@posteo.de>
+ *
+ *  This program is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU General Public License as
+ *  published by the Free Software Foundation; either version 2 of
+ *  the License, or (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "keyboardlayoutdata.h"
+
+#include "abstractkey.h"
+#include "key.h"
+#include "keyboardlayout.h"
+
+KeyboardLayoutData::KeyboardLayoutData():
+    width(0),
+    height(0)
+{
+}
+
+KeyboardLayoutData KeyboardLayoutData::fromKeyboardLayout(const KeyboardLayout* source)
+{
+    KeyboardLayoutData data;
+    data.id = source->id();
+    data.title = source->title();
+    data.name = source->name();
+    data.width = source->width();
+    data.height = source->height();
+    data.keys.reserve(source->keyCount());
+
+    for (int i = 0; i < source->keyCount(); i++)
+    {
+        AbstractKey* const abstractKey = source->key(i);
+        KeyData keyData = {false, abstractKey->rect(), 0, false, data.keyChars.count(), 0, SpecialKey::Other, QString(), QString()};
+
+        if (Key* const key = qobject_cast<Key*>(abstractKey))
+        {
+            keyData.fingerIndex = key->fingerIndex();
+            keyData.hasHapticMarker = key->hasHapticMarker();
+            keyData.keyCharCount = key->keyCharCount();
+
+            foreach (KeyChar* keyChar, key->keyChars())
+            {
+                data.keyChars.append({keyChar->value(), keyChar->position(), keyChar->modifier()});
+            }
+        }
+        else if (SpecialKey* const specialKey = qobject_cast<SpecialKey*>(abstractKey))
+        {
+            keyData.isSpecialKey = true;
+            keyData.specialKeyType = specialKey->type();
+            keyData.modifierId = specialKey->modifierId();
+            keyData.label = specialKey->label();
+        }
+        else
+        {
+            continue;
+        }
+
+        data.keys.append(keyData);
+    }
+
+    return data;
+}
+
+void KeyboardLayoutData::applyTo(KeyboardLayout* target) const
+{
+    target->setIsValid(false);
+    target->setId(id);
+    target->setTitle(title);
+    target->setName(name);
+    target->setWidth(width);
+    target->setHeight(height);
+    target->beginBatch();
+    target->clearKeys();
+
+    foreach (const KeyData& keyData, keys)
+    {
+        AbstractKey* abstractKey;
+
+        if (keyData.isSpecialKey)
+        {
+            SpecialKey* specialKey = new SpecialKey(target);
+            specialKey->setType(keyData.specialKeyType);
+            specialKey->setModifierId(keyData.modifierId);
+            specialKey->setLabel(keyData.label);
+            abstractKey = specialKey;
+        }
+        else
+        {
+            Key* key = new Key(target);
+            key->setFingerIndex(keyData.fingerIndex);
+            key->setHasHapticMarker(keyData.hasHapticMarker);
+
+            for (int i = keyData.firstKeyChar; i < keyData.firstKeyChar + keyData.keyCharCount; i++)
+            {
+                const KeyCharData& keyCharData = keyChars.at(i);
+                KeyChar* keyChar = new KeyChar(key);
+                keyChar->setValue(keyCharData.value);
+                keyChar->setPosition(keyCharData.position);
+                keyChar->setModifier(keyCharData.modifier);
+                key->addKeyChar(keyChar);
+            }
+
+            abstractKey = key;
+        }
+
+        abstractKey->setRect(keyData.rect);
+        target->addKey(abstractKey);
+    }
+
+    target->endBatch();
+    target->setIsValid(true);
+}
+
+int KeyboardLayoutData::cost() const
+{
+    int cost = int(sizeof(KeyboardLayoutData));
+    cost += (id.length() + title.length() + name.length()) * int(sizeof(QChar));
+    cost += keys.capacity() * int(sizeof(KeyData));
+    cost += keyChars.capacity() * int(sizeof(KeyCharData));
+
+    foreach (const KeyData& keyData, keys)
+    {
+        cost += (keyData.modifierId.length() + keyData.label.length()) * int(sizeof(QChar));
+    }
+
+    foreach (const KeyCharData& keyCharData, keyChars)
+    {
+        cost += keyCharData.modifier.length() * int(sizeof(QChar));
+    }
+
+    return cost;
+}
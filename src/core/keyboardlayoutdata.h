@@ -0,0 +1,79 @@
+/*
+ *  Copyright 2026  Sebastian Gottfried <sebastian.gottfried@posteo.de>
+ *
+ *  This program is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU General Public License as
+ *  published by the Free Software Foundation; either version 2 of
+ *  the License, or (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef KEYBOARDLAYOUTDATA_H
+#define KEYBOARDLAYOUTDATA_H
+
+#include <QChar>
+#include <QRect>
+#include <QString>
+#include <QVector>
+
+#include "keychar.h"
+#include "specialkey.h"
+
+class KeyboardLayout;
+
+/**
+ * Plain value copy of a keyboard layout.
+ *
+ * Keys and key characters are kept in two contiguous arrays, the characters
+ * of a key are a range of keyChars. Parsed built-in layouts are stored like
+ * this in the ResourceCache, the Key and KeyChar objects are only created
+ * when the data is applied to a KeyboardLayout shown in QML or the editor.
+ */
+struct KeyboardLayoutData
+{
+    struct KeyCharData
+    {
+        QChar value;
+        KeyChar::Position position;
+        QString modifier;
+    };
+
+    struct KeyData
+    {
+        bool isSpecialKey;
+        QRect rect;
+        int fingerIndex;
+        bool hasHapticMarker;
+        int firstKeyChar;
+        int keyCharCount;
+        SpecialKey::Type specialKeyType;
+        QString modifierId;
+        QString label;
+    };
+
+    KeyboardLayoutData();
+    static KeyboardLayoutData fromKeyboardLayout(const KeyboardLayout* source);
+    void applyTo(KeyboardLayout* target) const;
+    // rough estimate of the memory held by the data, in bytes
+    int cost() const;
+
+    QString id;
+    QString title;
+    QString name;
+    int width;
+    int height;
+    QVector<KeyData> keys;
+    QVector<KeyCharData> keyChars;
+};
+
+Q_DECLARE_TYPEINFO(KeyboardLayoutData::KeyCharData, Q_MOVABLE_TYPE);
+Q_DECLARE_TYPEINFO(KeyboardLayoutData::KeyData, Q_MOVABLE_TYPE);
+
+#endif // KEYBOARDLAYOUTDATA_H
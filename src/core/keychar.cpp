@@ -43,26 +43,31 @@ QString KeyChar::positionStr() const
 }
 
 void KeyChar::setPositionStr(const QString &position)
+{
+    m_position = positionFromStr(position);
+}
+
+KeyChar::Position KeyChar::positionFromStr(const QString& position)
 {
     if (position == QLatin1String("topLeft"))
     {
-        m_position = KeyChar::TopLeft;
+        return KeyChar::TopLeft;
     }
     else if (position == QLatin1String("topRight"))
     {
-        m_position = KeyChar::TopRight;
+        return KeyChar::TopRight;
     }
     else if (position == QLatin1String("bottomLeft"))
     {
-        m_position = KeyChar::BottomLeft;
+        return KeyChar::BottomLeft;
     }
     else if (position == QLatin1String("bottomRight"))
     {
-        m_position = KeyChar::BottomRight;
+        return KeyChar::BottomRight;
     }
     else
     {
-        m_position = KeyChar::Hidden;
+        return KeyChar::Hidden;
     }
 }
 
@@ -44,6 +44,7 @@ public:
     explicit KeyChar(QObject *parent = 0);
     QString positionStr() const;
     void setPositionStr(const QString& positionStr);
+    static Position positionFromStr(const QString& positionStr);
     QChar value() const;
     void setValue(const QChar& value);
     Position position() const;
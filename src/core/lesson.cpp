@@ -74,10 +74,16 @@ void Lesson::setCharacters(const QString& characters)
     if(characters != m_characters)
     {
         m_characters = characters;
+        m_characterSet = CharacterSet(characters);
         emit charactersChanged();
     }
 }
 
+const CharacterSet& Lesson::characterSet() const
+{
+    return m_characterSet;
+}
+
 QString Lesson::text()
 {
     return m_text;
@@ -88,10 +94,26 @@ void Lesson::setText(const QString& text)
     if (text != m_text)
     {
         m_text = text;
+        m_textIndex = LessonTextIndex(text);
         emit textChanged();
     }
 }
 
+const LessonTextIndex& Lesson::textIndex() const
+{
+    return m_textIndex;
+}
+
+int Lesson::lineCount() const
+{
+    return m_textIndex.lineCount();
+}
+
+QStringView Lesson::line(int index) const
+{
+    return m_textIndex.line(index);
+}
+
 void Lesson::copyFrom(Lesson* source)
 {
     setId(source->id());
@@ -22,6 +22,9 @@
 #include <QString>
 #include <QList>
 
+#include "characterset.h"
+#include "lessontextindex.h"
+
 class Lesson : public QObject
 {
     Q_OBJECT
@@ -41,8 +44,12 @@ public:
     void setNewCharacters(const QString& newCharacters);
     QString characters() const;
     void setCharacters(const QString& characters);
+    const CharacterSet& characterSet() const;
     QString text();
     void setText(const QString& text);
+    const LessonTextIndex& textIndex() const;
+    int lineCount() const;
+    QStringView line(int index) const;
     Q_INVOKABLE void copyFrom(Lesson* source);
 
 signals:
@@ -58,7 +65,9 @@ private:
     QString m_title;
     QString m_newCharacters;
     QString m_characters;
+    CharacterSet m_characterSet;
     QString m_text;
+    LessonTextIndex m_textIndex;
 };
 
 #endif // LESSON_H
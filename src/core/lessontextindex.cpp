@@ -0,0 +1,111 @@
+/*
+ *  Copyright 2026  Sebastian Gottfried <sebastian.gottfried@posteo.de>
+ *
+ *  This program is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU General Public License as
+ *  published by the Free Software Foundation; either version 2 of
+ *  the License, or (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "lessontextindex.h"
+
+#include <QTextBoundaryFinder>
+
+#include "characterset.h"
+#include "textkernels.h"
+
+LessonTextIndex::LessonTextIndex(const QString& text):
+    m_text(text),
+    m_lineTableBuilt(false),
+    m_distinctCharactersBuilt(false),
+    m_graphemeBoundariesBuilt(false)
+{
+}
+
+QString LessonTextIndex::text() const
+{
+    return m_text;
+}
+
+int LessonTextIndex::lineCount() const
+{
+    buildLineTable();
+    return m_lineOffsets.length();
+}
+
+QStringView LessonTextIndex::line(int index) const
+{
+    buildLineTable();
+    return QStringView(m_text).mid(m_lineOffsets.at(index), m_lineLengths.at(index));
+}
+
+int LessonTextIndex::lineOffset(int index) const
+{
+    buildLineTable();
+    return m_lineOffsets.at(index);
+}
+
+int LessonTextIndex::lineLength(int index) const
+{
+    buildLineTable();
+    return m_lineLengths.at(index);
+}
+
+QString LessonTextIndex::distinctCharacters() const
+{
+    if (!m_distinctCharactersBuilt)
+    {
+        CharacterSet characterSet;
+        m_distinctCharacters = QLatin1String("");
+        TextKernels::collectDistinct(m_text.constData(), m_text.length(), characterSet, m_distinctCharacters);
+        m_distinctCharactersBuilt = true;
+    }
+
+    return m_distinctCharacters;
+}
+
+QVector<int> LessonTextIndex::graphemeBoundaries() const
+{
+    if (!m_graphemeBoundariesBuilt)
+    {
+        QTextBoundaryFinder finder(QTextBoundaryFinder::Grapheme, m_text);
+        m_graphemeBoundaries.append(0);
+
+        for (int pos = finder.toNextBoundary(); pos != -1; pos = finder.toNextBoundary())
+        {
+            m_graphemeBoundaries.append(pos);
+        }
+
+        m_graphemeBoundariesBuilt = true;
+    }
+
+    return m_graphemeBoundaries;
+}
+
+void LessonTextIndex::buildLineTable() const
+{
+    if (m_lineTableBuilt)
+        return;
+
+    // same lines as QString::split('\n'), an empty text has a single empty line
+    int offset = 0;
+
+    for (int pos = m_text.indexOf(QLatin1Char('\n')); pos != -1; pos = m_text.indexOf(QLatin1Char('\n'), offset))
+    {
+        m_lineOffsets.append(offset);
+        m_lineLengths.append(pos - offset);
+        offset = pos + 1;
+    }
+
+    m_lineOffsets.append(offset);
+    m_lineLengths.append(m_text.length() - offset);
+    m_lineTableBuilt = true;
+}
@@ -0,0 +1,65 @@
+/*
+ *  Copyright 2026  Sebastian Gottfried <sebastian.gottfried@posteo.de>
+ *
+ *  This program is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU General Public License as
+ *  published by the Free Software Foundation; either version 2 of
+ *  the License, or (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef LESSONTEXTINDEX_H
+#define LESSONTEXTINDEX_H
+
+#include <QString>
+#include <QStringView>
+#include <QVector>
+
+/**
+ * Index of a lesson text. The line table, the distinct characters and the
+ * grapheme boundaries are only computed on first use. Replacing the text
+ * means replacing the index, which drops all of them.
+ *
+ * The index keeps a shallow copy of the text, so the line views stay valid
+ * as long as the index is alive.
+ */
+class LessonTextIndex
+{
+public:
+    explicit LessonTextIndex(const QString& text = QString());
+    QString text() const;
+    int lineCount() const;
+    QStringView line(int index) const;
+    int lineOffset(int index) const;
+    int lineLength(int index) const;
+    /**
+     * Returns every character of the text once, in the order of their
+     * first occurrence.
+     */
+    QString distinctCharacters() const;
+    /**
+     * Returns the positions at which user-perceived characters start, as
+     * found by QTextBoundaryFinder, followed by the length of the text.
+     */
+    QVector<int> graphemeBoundaries() const;
+
+private:
+    void buildLineTable() const;
+    QString m_text;
+    mutable QVector<int> m_lineOffsets;
+    mutable QVector<int> m_lineLengths;
+    mutable QString m_distinctCharacters;
+    mutable QVector<int> m_graphemeBoundaries;
+    mutable bool m_lineTableBuilt;
+    mutable bool m_distinctCharactersBuilt;
+    mutable bool m_graphemeBoundariesBuilt;
+};
+
+#endif // LESSONTEXTINDEX_H
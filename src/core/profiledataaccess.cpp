@@ -260,7 +260,7 @@ void ProfileDataAccess::loadReferenceTrainingStats(TrainingStats* stats, Profile
     stats->setCharactersTyped(0);
     stats->setElapsedTime(QTime());
     stats->setErrorCount(0);
-    stats->setErrorMap(QMap<QString, int>());
+    stats->setErrorMap(CharacterErrorMap());
     stats->setIsValid(false);
 
     QSqlDatabase db = database();
@@ -309,13 +309,17 @@ void ProfileDataAccess::loadReferenceTrainingStats(TrainingStats* stats, Profile
         return;
     }
 
-    QMap<QString, int> errorMap;
+    CharacterErrorMap errorMap;
 
     while (errorSelectQuery.next())
     {
         const QString character = errorSelectQuery.value(0).toString();
         const int errorCount = errorSelectQuery.value(1).toInt();
-        errorMap.insert(character, errorCount);
+
+        if (character.length() == 1)
+        {
+            errorMap.setErrorCount(character.at(0), errorCount);
+        }
     }
 
     stats->setErrorMap(errorMap);
@@ -384,13 +388,13 @@ void ProfileDataAccess::saveTrainingStats(TrainingStats* stats, Profile* profile
         return;
     }
 
-    QMapIterator<QString, int> errorIterator(stats->errorMap());
-    while(errorIterator.hasNext())
+    const CharacterErrorMap& errorMap = stats->errorMap();
+    for (int i = 0; i < errorMap.characterCount(); i++)
     {
-        errorIterator.next();
+        const QChar character = errorMap.character(i);
         addErrorsQuery.bindValue(0, statsId);
-        addErrorsQuery.bindValue(1, errorIterator.key());
-        addErrorsQuery.bindValue(2, errorIterator.value());
+        addErrorsQuery.bindValue(1, QString(character));
+        addErrorsQuery.bindValue(2, errorMap.errorCount(character));
 
         if (!addErrorsQuery.exec())
         {
@@ -637,21 +641,8 @@ bool ProfileDataAccess::loadCustomLessons(Profile* profile, const QString& keybo
         lesson->setId(query.value(0).toString());
         lesson->setTitle(query.value(1).toString());
 
-        const QString text = query.value(2).toString();
-        QString characters = QLatin1String("");
-
-        for (int i = 0; i < text.length(); i++)
-        {
-            const QChar character = text.at(i);
-
-            if (!characters.contains(character))
-            {
-                characters.append(character);
-            }
-        }
-
-        lesson->setText(text);
-        lesson->setCharacters(characters);
+        lesson->setText(query.value(2).toString());
+        lesson->setCharacters(lesson->textIndex().distinctCharacters());
 
         target->addLesson(lesson);
     }
@@ -0,0 +1,288 @@
+/*
+ *  Copyright 2026  Sebastian Gottfried <sebastian.gottfried@posteo.de>
+ *
+ *  This program is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU General Public License as
+ *  published by the Free Software Foundation; either version 2 of
+ *  the License, or (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "resourcecache.h"
+
+#include <QCoreApplication>
+#include <QFileInfo>
+#include <QFutureWatcher>
+#include <QThread>
+#include <QtConcurrent>
+
+#include "course.h"
+#include "keyboardlayout.h"
+#include "keyboardlayoutdata.h"
+#include "lesson.h"
+#include "resourcedataaccess.h"
+
+namespace
+{
+    // rough upper bound of the memory held by the cached resources, in bytes
+    const int maxCacheCost = 8 * 1024 * 1024;
+
+    // estimated overhead of a QObject with its private data and connections
+    const int objectCost = 256;
+
+    int courseCost(Course* course)
+    {
+        int cost = objectCost;
+
+        for (int i = 0; i < course->lessonCount(); i++)
+        {
+            Lesson* const lesson = course->lesson(i);
+            const int length = lesson->id().length() + lesson->title().length() + lesson->newCharacters().length() + lesson->characters().length() + lesson->text().length();
+            cost += objectCost + length * int(sizeof(QChar));
+        }
+
+        return cost;
+    }
+
+    Course* parseCourse(const QString& path, QThread* targetThread)
+    {
+        Course* course = new Course();
+        ResourceDataAccess resourceDataAccess;
+
+        if (!resourceDataAccess.loadCourse(path, course))
+        {
+            delete course;
+            return 0;
+        }
+
+        course->moveToThread(targetThread);
+        return course;
+    }
+
+    KeyboardLayoutData* parseKeyboardLayout(const QString& path)
+    {
+        KeyboardLayoutData* keyboardLayout = new KeyboardLayoutData();
+        ResourceDataAccess resourceDataAccess;
+
+        if (!resourceDataAccess.loadKeyboardLayoutData(path, keyboardLayout))
+        {
+            delete keyboardLayout;
+            return 0;
+        }
+
+        return keyboardLayout;
+    }
+}
+
+ResourceCache::Entry::Entry(Course* course, KeyboardLayoutData* keyboardLayout, const QDateTime& lastModified):
+    course(course),
+    keyboardLayout(keyboardLayout),
+    lastModified(lastModified)
+{
+}
+
+ResourceCache::Entry::~Entry()
+{
+    delete course;
+    delete keyboardLayout;
+}
+
+ResourceCache::ResourceCache(QObject* parent):
+    QObject(parent),
+    m_entries(maxCacheCost)
+{
+}
+
+ResourceCache* ResourceCache::instance()
+{
+    static ResourceCache* cache = new ResourceCache(QCoreApplication::instance());
+    return cache;
+}
+
+Course* ResourceCache::course(const QString& path)
+{
+    Entry* const entry = lookup(path);
+    return entry? entry->course: 0;
+}
+
+const KeyboardLayoutData* ResourceCache::keyboardLayout(const QString& path)
+{
+    Entry* const entry = lookup(path);
+    return entry? entry->keyboardLayout: 0;
+}
+
+bool ResourceCache::loadCourse(const QString& path, Course* target)
+{
+    Course* course = this->course(path);
+
+    if (!course)
+    {
+        course = parseCourse(path, thread());
+
+        if (!course)
+        {
+            target->setIsValid(false);
+            return false;
+        }
+
+        target->copyFrom(course);
+
+        if (!insert(path, course))
+        {
+            delete course;
+        }
+
+        return true;
+    }
+
+    target->copyFrom(course);
+    return true;
+}
+
+bool ResourceCache::loadKeyboardLayout(const QString& path, KeyboardLayout* target)
+{
+    const KeyboardLayoutData* keyboardLayout = this->keyboardLayout(path);
+
+    if (!keyboardLayout)
+    {
+        KeyboardLayoutData* const parsedKeyboardLayout = parseKeyboardLayout(path);
+
+        if (!parsedKeyboardLayout)
+        {
+            target->setIsValid(false);
+            return false;
+        }
+
+        parsedKeyboardLayout->applyTo(target);
+
+        if (!insert(path, parsedKeyboardLayout))
+        {
+            delete parsedKeyboardLayout;
+        }
+
+        return true;
+    }
+
+    keyboardLayout->applyTo(target);
+    return true;
+}
+
+void ResourceCache::requestCourse(const QString& path)
+{
+    if (m_pendingCourses.contains(path) || course(path))
+        return;
+
+    m_pendingCourses.insert(path);
+
+    auto watcher = new QFutureWatcher<Course*>(this);
+    connect(watcher, &QFutureWatcherBase::finished, this, [=] {
+        onCourseParsed(path, watcher->result());
+        watcher->deleteLater();
+    });
+    watcher->setFuture(QtConcurrent::run(parseCourse, path, thread()));
+}
+
+void ResourceCache::requestKeyboardLayout(const QString& path)
+{
+    if (m_pendingKeyboardLayouts.contains(path) || keyboardLayout(path))
+        return;
+
+    m_pendingKeyboardLayouts.insert(path);
+
+    auto watcher = new QFutureWatcher<KeyboardLayoutData*>(this);
+    connect(watcher, &QFutureWatcherBase::finished, this, [=] {
+        onKeyboardLayoutParsed(path, watcher->result());
+        watcher->deleteLater();
+    });
+    watcher->setFuture(QtConcurrent::run(parseKeyboardLayout, path));
+}
+
+bool ResourceCache::isCoursePending(const QString& path) const
+{
+    return m_pendingCourses.contains(path);
+}
+
+bool ResourceCache::isKeyboardLayoutPending(const QString& path) const
+{
+    return m_pendingKeyboardLayouts.contains(path);
+}
+
+void ResourceCache::remove(const QString& path)
+{
+    m_entries.remove(path);
+}
+
+ResourceCache::Entry* ResourceCache::lookup(const QString& path)
+{
+    Entry* const entry = m_entries.object(path);
+
+    if (!entry)
+        return 0;
+
+    if (entry->lastModified != QFileInfo(path).lastModified())
+    {
+        m_entries.remove(path);
+        return 0;
+    }
+
+    return entry;
+}
+
+bool ResourceCache::insert(const QString& path, Course* course)
+{
+    const int cost = courseCost(course);
+
+    // QCache would delete an entry exceeding the whole cache right away
+    if (cost > m_entries.maxCost())
+        return false;
+
+    m_entries.insert(path, new Entry(course, 0, QFileInfo(path).lastModified()), cost);
+    return true;
+}
+
+bool ResourceCache::insert(const QString& path, KeyboardLayoutData* keyboardLayout)
+{
+    const int cost = keyboardLayout->cost();
+
+    if (cost > m_entries.maxCost())
+        return false;
+
+    m_entries.insert(path, new Entry(0, keyboardLayout, QFileInfo(path).lastModified()), cost);
+    return true;
+}
+
+void ResourceCache::onCourseParsed(const QString& path, Course* course)
+{
+    m_pendingCourses.remove(path);
+
+    // cache it first, so receivers looking it up already find it
+    const bool cached = course && insert(path, course);
+
+    emit courseAvailable(path, course);
+
+    if (course && !cached)
+    {
+        delete course;
+    }
+}
+
+void ResourceCache::onKeyboardLayoutParsed(const QString& path, KeyboardLayoutData* keyboardLayout)
+{
+    m_pendingKeyboardLayouts.remove(path);
+
+    const bool cached = keyboardLayout && insert(path, keyboardLayout);
+
+    emit keyboardLayoutAvailable(path, keyboardLayout);
+
+    if (keyboardLayout && !cached)
+    {
+        delete keyboardLayout;
+    }
+}
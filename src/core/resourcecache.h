@@ -0,0 +1,93 @@
+/*
+ *  Copyright 2026  Sebastian Gottfried <sebastian.gottfried@posteo.de>
+ *
+ *  This program is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU General Public License as
+ *  published by the Free Software Foundation; either version 2 of
+ *  the License, or (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef RESOURCECACHE_H
+#define RESOURCECACHE_H
+
+#include <QObject>
+#include <QCache>
+#include <QDateTime>
+#include <QSet>
+
+class Course;
+class KeyboardLayout;
+struct KeyboardLayoutData;
+
+/**
+ * Keeps parsed built-in courses and keyboard layouts around, so they don't
+ * have to be parsed and validated again every time they are selected.
+ * The cache is bounded by the estimated memory usage of the resources and
+ * evicts the least recently used ones first. Entries are keyed by path and
+ * are dropped once the file on disk has been modified. Keyboard layouts are
+ * kept as KeyboardLayoutData values, so cached layouts don't hold any key
+ * objects.
+ *
+ * Resources can be parsed on the global thread pool with requestCourse()
+ * and requestKeyboardLayout(). The cache has to be used from the GUI thread
+ * only.
+ */
+class ResourceCache : public QObject
+{
+    Q_OBJECT
+public:
+    static ResourceCache* instance();
+    Course* course(const QString& path);
+    const KeyboardLayoutData* keyboardLayout(const QString& path);
+    bool loadCourse(const QString& path, Course* target);
+    bool loadKeyboardLayout(const QString& path, KeyboardLayout* target);
+    void requestCourse(const QString& path);
+    void requestKeyboardLayout(const QString& path);
+    bool isCoursePending(const QString& path) const;
+    bool isKeyboardLayoutPending(const QString& path) const;
+    void remove(const QString& path);
+
+signals:
+    /**
+     * Emitted after a requested course has been parsed. @p course is only
+     * valid during the signal emission and is null if the course couldn't
+     * be loaded.
+     */
+    void courseAvailable(const QString& path, Course* course);
+    /**
+     * Emitted after a requested keyboard layout has been parsed.
+     * @p keyboardLayout is only valid during the signal emission and is null
+     * if the keyboard layout couldn't be loaded.
+     */
+    void keyboardLayoutAvailable(const QString& path, const KeyboardLayoutData* keyboardLayout);
+
+private:
+    struct Entry
+    {
+        Entry(Course* course, KeyboardLayoutData* keyboardLayout, const QDateTime& lastModified);
+        ~Entry();
+        // exactly one of them is set
+        Course* course;
+        KeyboardLayoutData* keyboardLayout;
+        QDateTime lastModified;
+    };
+    explicit ResourceCache(QObject* parent = 0);
+    Entry* lookup(const QString& path);
+    bool insert(const QString& path, Course* course);
+    bool insert(const QString& path, KeyboardLayoutData* keyboardLayout);
+    void onCourseParsed(const QString& path, Course* course);
+    void onKeyboardLayoutParsed(const QString& path, KeyboardLayoutData* keyboardLayout);
+    QCache<QString, Entry> m_entries;
+    QSet<QString> m_pendingCourses;
+    QSet<QString> m_pendingKeyboardLayouts;
+};
+
+#endif // RESOURCECACHE_H
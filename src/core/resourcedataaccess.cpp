@@ -20,30 +20,71 @@
 #include <QDebug>
 #include <QDir>
 #include <QFile>
+#include <QSaveFile>
 #include <QDomDocument>
 #include <QDomElement>
 #include <QDomNodeList>
 #include <QUrl>
 #include <QStandardPaths>
+#include <QThread>
+#include <QThreadStorage>
 #include <QXmlSchema>
 #include <QXmlSchemaValidator>
+#include <QXmlStreamWriter>
+#include <QAbstractMessageHandler>
+#include <QtConcurrent>
 
 
 #include "dataindex.h"
 #include "keyboardlayout.h"
+#include "keyboardlayoutdata.h"
 #include "key.h"
 #include "specialkey.h"
 #include "keychar.h"
 #include "course.h"
 #include "lesson.h"
 
+namespace
+{
+    class ValidationMessageHandler : public QAbstractMessageHandler
+    {
+    public:
+        QString message() const
+        {
+            return m_message;
+        }
+
+    protected:
+        void handleMessage(QtMsgType type, const QString& description, const QUrl& identifier, const QSourceLocation& sourceLocation) override
+        {
+            Q_UNUSED(identifier)
+
+            if (type == QtDebugMsg || !m_message.isEmpty())
+                return;
+
+            m_message = QStringLiteral("line %1, column %2: %3").arg(sourceLocation.line()).arg(sourceLocation.column()).arg(description);
+        }
+
+    private:
+        QString m_message;
+    };
+
+    // schemata are implicitly shared and not safe to use from different
+    // threads at the same time, so every worker thread loads its own
+    QThreadStorage<QHash<QString, QXmlSchema>> threadSchemata;
+
+    const char xmlHeader[] = "<?xml version=\"1.0\"?>";
+}
+
 ResourceDataAccess::ResourceDataAccess(QObject *parent) :
     QObject(parent)
 {
 }
 
-bool ResourceDataAccess::fillDataIndex(DataIndex* target)
+bool ResourceDataAccess::fillDataIndex(DataIndex* target, bool validateResources)
 {
+    QList<ResourceFile> resourceFiles;
+
     QXmlSchema schema = loadXmlSchema(QStringLiteral("data"));
     if (!schema.isValid())
         return false;
@@ -81,6 +122,7 @@ bool ResourceDataAccess::fillDataIndex(DataIndex* target)
                 course->setPath(path);
                 course->setSource(DataIndex::BuiltInResource);
                 target->addCourse(course);
+                resourceFiles.append({course, path, QStringLiteral("course")});
             }
             else if (dataNode.tagName() == QLatin1String("keyboardLayout"))
             {
@@ -91,6 +133,22 @@ bool ResourceDataAccess::fillDataIndex(DataIndex* target)
                 keyboardLayout->setPath(path);
                 keyboardLayout->setSource(DataIndex::BuiltInResource);
                 target->addKeyboardLayout(keyboardLayout);
+                resourceFiles.append({keyboardLayout, path, QStringLiteral("keyboardlayout")});
+            }
+        }
+    }
+
+    if (validateResources)
+    {
+        // a broken resource is flagged as invalid instead of failing the whole index
+        const QStringList errors = QtConcurrent::blockingMapped<QStringList>(resourceFiles, &ResourceDataAccess::validateResourceFile);
+
+        for (int i = 0; i < resourceFiles.count(); i++)
+        {
+            if (!errors.at(i).isNull())
+            {
+                qWarning() << "invalid resource:" << resourceFiles.at(i).path << errors.at(i);
+                resourceFiles.at(i).resource->setIsValid(false);
             }
         }
     }
@@ -98,10 +156,30 @@ bool ResourceDataAccess::fillDataIndex(DataIndex* target)
     return true;
 }
 
+DataIndex* ResourceDataAccess::loadDataIndex(QThread* targetThread)
+{
+    DataIndex* dataIndex = new DataIndex();
+    ResourceDataAccess resourceDataAccess;
+    dataIndex->setIsValid(resourceDataAccess.fillDataIndex(dataIndex, true));
+    dataIndex->moveToThread(targetThread);
+    return dataIndex;
+}
+
 bool ResourceDataAccess::loadKeyboardLayout(const QString &path, KeyboardLayout* target)
 {
     target->setIsValid(false);
 
+    KeyboardLayoutData data;
+
+    if (!loadKeyboardLayoutData(path, &data))
+        return false;
+
+    data.applyTo(target);
+    return true;
+}
+
+bool ResourceDataAccess::loadKeyboardLayoutData(const QString& path, KeyboardLayoutData* target)
+{
     QFile keyboardLayoutFile;
     keyboardLayoutFile.setFileName(path);
     if (!keyboardLayoutFile.open(QIODevice::ReadOnly))
@@ -120,163 +198,158 @@ bool ResourceDataAccess::loadKeyboardLayout(const QString &path, KeyboardLayout*
     }
     QDomElement root(doc.documentElement());
 
-    target->clearKeys();
-    target->setId(root.firstChildElement(QStringLiteral("id")).text());
-    target->setTitle(root.firstChildElement(QStringLiteral("title")).text());
-    target->setName(root.firstChildElement(QStringLiteral("name")).text());
-    target->setWidth(root.firstChildElement(QStringLiteral("width")).text().toInt());
-    target->setHeight(root.firstChildElement(QStringLiteral("height")).text().toInt());
+    *target = KeyboardLayoutData();
+    target->id = root.firstChildElement(QStringLiteral("id")).text();
+    target->title = root.firstChildElement(QStringLiteral("title")).text();
+    target->name = root.firstChildElement(QStringLiteral("name")).text();
+    target->width = root.firstChildElement(QStringLiteral("width")).text().toInt();
+    target->height = root.firstChildElement(QStringLiteral("height")).text().toInt();
     for (QDomElement keyNode = root.firstChildElement(QStringLiteral("keys")).firstChildElement();
          !keyNode.isNull();
          keyNode = keyNode.nextSiblingElement())
     {
-        AbstractKey* abstractKey;
+        KeyboardLayoutData::KeyData key = {false, QRect(), 0, false, target->keyChars.count(), 0, SpecialKey::Other, QString(), QString()};
 
         if (keyNode.tagName() == QLatin1String("key"))
         {
-            Key* key = new Key(this);
-            key->setFingerIndex(keyNode.attribute(QStringLiteral("fingerIndex")).toInt());
-            key->setHasHapticMarker(keyNode.attribute(QStringLiteral("hasHapticMarker")) == QLatin1String("true"));
+            key.fingerIndex = keyNode.attribute(QStringLiteral("fingerIndex")).toInt();
+            key.hasHapticMarker = keyNode.attribute(QStringLiteral("hasHapticMarker")) == QLatin1String("true");
             for (QDomElement charNode = keyNode.firstChildElement(QStringLiteral("char"));
                  !charNode.isNull();
                  charNode = charNode.nextSiblingElement(QStringLiteral("char")))
             {
-                KeyChar* keyChar = new KeyChar(key);
-                keyChar->setValue(charNode.text().at(0));
-                keyChar->setPositionStr(charNode.attribute(QStringLiteral("position")));
-                keyChar->setModifier(charNode.attribute(QStringLiteral("modifier")));
-                key->addKeyChar(keyChar);
+                target->keyChars.append({
+                    charNode.text().at(0),
+                    KeyChar::positionFromStr(charNode.attribute(QStringLiteral("position"))),
+                    charNode.attribute(QStringLiteral("modifier"))
+                });
+                key.keyCharCount++;
             }
-            abstractKey = key;
         }
         else if (keyNode.tagName() == QLatin1String("specialKey"))
         {
-            SpecialKey* specialKey = new SpecialKey(this);
-            specialKey->setTypeStr(keyNode.attribute(QStringLiteral("type")));
-            specialKey->setModifierId(keyNode.attribute(QStringLiteral("modifierId")));
-            specialKey->setLabel(keyNode.attribute(QStringLiteral("label")));
-            abstractKey = specialKey;
+            key.isSpecialKey = true;
+            key.specialKeyType = SpecialKey::typeFromStr(keyNode.attribute(QStringLiteral("type")));
+            key.modifierId = keyNode.attribute(QStringLiteral("modifierId"));
+            key.label = keyNode.attribute(QStringLiteral("label"));
         }
         else
         {
             continue;
         }
-        abstractKey->setLeft(keyNode.attribute(QStringLiteral("left")).toInt());
-        abstractKey->setTop(keyNode.attribute(QStringLiteral("top")).toInt());
-        abstractKey->setWidth(keyNode.attribute(QStringLiteral("width")).toInt());
-        abstractKey->setHeight(keyNode.attribute(QStringLiteral("height")).toInt());
-        target->addKey(abstractKey);
+        key.rect = QRect(
+            keyNode.attribute(QStringLiteral("left")).toInt(),
+            keyNode.attribute(QStringLiteral("top")).toInt(),
+            keyNode.attribute(QStringLiteral("width")).toInt(),
+            keyNode.attribute(QStringLiteral("height")).toInt());
+        target->keys.append(key);
     }
 
-    target->setIsValid(true);
     return true;
 }
 
 bool ResourceDataAccess::storeKeyboardLayout(const QString& path, KeyboardLayout* source)
 {
-    QDomDocument doc;
+    // the document is streamed into a temporary file which only replaces
+    // the target once it has been written completely
+    QSaveFile file(path);
 
-    QDomProcessingInstruction header = doc.createProcessingInstruction(QStringLiteral("xml"), QStringLiteral("version=\"1.0\""));
-    doc.appendChild(header);
+    if (!file.open(QIODevice::WriteOnly))
+    {
+        qWarning() << "can't open:" << file.fileName();
+        return false;
+    }
 
-    QDomElement root = doc.createElement(QStringLiteral("keyboardLayout"));
-    doc.appendChild(root);
+    // the header of the former QDomDocument based writer, writeStartDocument()
+    // would add an encoding declaration. With auto formatting the writer
+    // starts the root element on a new line.
+    file.write(xmlHeader);
 
-    QDomElement idElem = doc.createElement(QStringLiteral("id"));
-    QDomElement titleElem = doc.createElement(QStringLiteral("title"));
-    QDomElement nameElem = doc.createElement(QStringLiteral("name"));
-    QDomElement widthElem = doc.createElement(QStringLiteral("width"));
-    QDomElement heightElem = doc.createElement(QStringLiteral("height"));
-    QDomElement keysElem = doc.createElement(QStringLiteral("keys"));
+    QXmlStreamWriter writer(&file);
+    writer.setAutoFormatting(true);
+    writer.setAutoFormattingIndent(1);
 
-    idElem.appendChild(doc.createTextNode(source->id()));
-    titleElem.appendChild(doc.createTextNode(source->title()));
-    nameElem.appendChild(doc.createTextNode(source->name()));
-    heightElem.appendChild(doc.createTextNode(QString::number(source->height())));
-    widthElem.appendChild(doc.createTextNode(QString::number(source->width())));
+    writer.writeStartElement(QStringLiteral("keyboardLayout"));
+    writer.writeTextElement(QStringLiteral("id"), source->id());
+    writer.writeTextElement(QStringLiteral("title"), source->title());
+    writer.writeTextElement(QStringLiteral("name"), source->name());
+    writer.writeTextElement(QStringLiteral("width"), QString::number(source->width()));
+    writer.writeTextElement(QStringLiteral("height"), QString::number(source->height()));
+    writer.writeStartElement(QStringLiteral("keys"));
 
     for (int i = 0; i < source->keyCount(); i++)
     {
         AbstractKey* const abstractKey = source->key(i);
+        Key* const key = qobject_cast<Key*>(abstractKey);
+        SpecialKey* const specialKey = qobject_cast<SpecialKey*>(abstractKey);
 
-        QDomElement keyElem = doc.createElement(QStringLiteral("key"));
-
-        keyElem.setAttribute(QStringLiteral("left"), abstractKey->left());
-        keyElem.setAttribute(QStringLiteral("top"), abstractKey->top());
-        keyElem.setAttribute(QStringLiteral("width"), abstractKey->width());
-        keyElem.setAttribute(QStringLiteral("height"), abstractKey->height());
+        writer.writeStartElement(specialKey? QStringLiteral("specialKey"): QStringLiteral("key"));
+        writer.writeAttribute(QStringLiteral("left"), QString::number(abstractKey->left()));
+        writer.writeAttribute(QStringLiteral("top"), QString::number(abstractKey->top()));
+        writer.writeAttribute(QStringLiteral("width"), QString::number(abstractKey->width()));
+        writer.writeAttribute(QStringLiteral("height"), QString::number(abstractKey->height()));
 
-        if (Key* const key = qobject_cast<Key*>(abstractKey))
+        if (key)
         {
-            keyElem.setTagName(QStringLiteral("key"));
-            keyElem.setAttribute(QStringLiteral("fingerIndex"), key->fingerIndex());
+            writer.writeAttribute(QStringLiteral("fingerIndex"), QString::number(key->fingerIndex()));
             if (key->hasHapticMarker())
             {
-                keyElem.setAttribute(QStringLiteral("hasHapticMarker"), QStringLiteral("true"));
+                writer.writeAttribute(QStringLiteral("hasHapticMarker"), QStringLiteral("true"));
             }
 
             for (int j = 0; j < key->keyCharCount(); j++)
             {
                 KeyChar* const keyChar = key->keyChar(j);
 
-                QDomElement keyCharElem = doc.createElement(QStringLiteral("char"));
-                keyCharElem.setAttribute(QStringLiteral("position"), keyChar->positionStr());
+                writer.writeStartElement(QStringLiteral("char"));
+                writer.writeAttribute(QStringLiteral("position"), keyChar->positionStr());
                 const QString modifier = keyChar->modifier();
                 if (!modifier.isEmpty())
                 {
-                    keyCharElem.setAttribute(QStringLiteral("modifier"), modifier);
+                    writer.writeAttribute(QStringLiteral("modifier"), modifier);
                 }
                 const QString value = keyChar->value();
                 if (value == QLatin1Char(' '))
                 {
-                    keyCharElem.appendChild(doc.createCDATASection(value));
+                    writer.writeCDATA(value);
                 }
                 else
                 {
-                    keyCharElem.appendChild(doc.createTextNode(value));
+                    writer.writeCharacters(value);
                 }
-                keyElem.appendChild(keyCharElem);
+                writer.writeEndElement();
             }
         }
 
-        if (SpecialKey* const specialKey = qobject_cast<SpecialKey*>(abstractKey))
+        if (specialKey)
         {
-            keyElem.setTagName(QStringLiteral("specialKey"));
-            keyElem.setAttribute(QStringLiteral("type"), specialKey->typeStr());
+            writer.writeAttribute(QStringLiteral("type"), specialKey->typeStr());
 
             const QString modifierId = specialKey->modifierId();
             if (!modifierId.isNull())
             {
-                keyElem.setAttribute(QStringLiteral("modifierId"), modifierId);
+                writer.writeAttribute(QStringLiteral("modifierId"), modifierId);
             }
             const QString label = specialKey->label();
             if (!label.isNull())
             {
-                keyElem.setAttribute(QStringLiteral("label"), label);
+                writer.writeAttribute(QStringLiteral("label"), label);
             }
         }
 
-        keysElem.appendChild(keyElem);
+        writer.writeEndElement();
     }
 
-    root.appendChild(idElem);
-    root.appendChild(titleElem);
-    root.appendChild(nameElem);
-    root.appendChild(widthElem);
-    root.appendChild(heightElem);
-    root.appendChild(keysElem);
-
-    QFile file;
-
-    file.setFileName(path);
+    writer.writeEndElement();
+    writer.writeEndElement();
+    writer.writeEndDocument();
 
-    if (!file.open(QIODevice::WriteOnly))
+    if (writer.hasError() || !file.commit())
     {
-        qWarning() << "can't open:" << file.fileName();
+        qWarning() << "can't write:" << file.fileName() << file.errorString();
         return false;
     }
 
-    file.write(doc.toByteArray());
     return true;
 }
 
@@ -307,6 +380,7 @@ bool ResourceDataAccess::loadCourse(const QString &path, Course* target)
     target->setDescription(root.firstChildElement(QStringLiteral("description")).text());
     target->setKeyboardLayoutName(root.firstChildElement(QStringLiteral("keyboardLayout")).text());
     target->setKind(Course::SequentialCourse);
+    target->beginBatch();
     target->clearLessons();
 
     for (QDomElement lessonNode = root.firstChildElement(QStringLiteral("lessons")).firstChildElement();
@@ -320,6 +394,7 @@ bool ResourceDataAccess::loadCourse(const QString &path, Course* target)
         lesson->setText(lessonNode.firstChildElement(QStringLiteral("text")).text());
         target->addLesson(lesson);
     }
+    target->endBatch();
 
     target->setIsValid(true);
     return true;
@@ -327,67 +402,49 @@ bool ResourceDataAccess::loadCourse(const QString &path, Course* target)
 
 bool ResourceDataAccess::storeCourse(const QString& path, Course* source)
 {
+    QSaveFile file(path);
 
-    QDomDocument doc;
-
-    QDomProcessingInstruction header = doc.createProcessingInstruction(QStringLiteral("xml"), QStringLiteral("version=\"1.0\""));
-    doc.appendChild(header);
+    if (!file.open(QIODevice::WriteOnly))
+    {
+        qWarning() << "can't open:" << file.fileName();
+        return false;
+    }
 
-    QDomElement root = doc.createElement(QStringLiteral("course"));
-    doc.appendChild(root);
+    file.write(xmlHeader);
 
-    QDomElement idElem = doc.createElement(QStringLiteral("id"));
-    QDomElement titleElem = doc.createElement(QStringLiteral("title"));
-    QDomElement descriptionElem = doc.createElement(QStringLiteral("description"));
-    QDomElement keyboardLayoutElem = doc.createElement(QStringLiteral("keyboardLayout"));
-    QDomElement lessonsElem = doc.createElement(QStringLiteral("lessons"));
+    QXmlStreamWriter writer(&file);
+    writer.setAutoFormatting(true);
+    writer.setAutoFormattingIndent(1);
 
-    idElem.appendChild(doc.createTextNode(source->id()));
-    titleElem.appendChild(doc.createTextNode(source->title()));
-    keyboardLayoutElem.appendChild(doc.createTextNode(source->keyboardLayoutName()));
-    descriptionElem.appendChild(doc.createTextNode(source->description()));
+    writer.writeStartElement(QStringLiteral("course"));
+    writer.writeTextElement(QStringLiteral("id"), source->id());
+    writer.writeTextElement(QStringLiteral("title"), source->title());
+    writer.writeTextElement(QStringLiteral("description"), source->description());
+    writer.writeTextElement(QStringLiteral("keyboardLayout"), source->keyboardLayoutName());
+    writer.writeStartElement(QStringLiteral("lessons"));
 
     for (int i = 0; i < source->lessonCount(); i++)
     {
         Lesson* const lesson = source->lesson(i);
 
-        QStringList lines;
-
-        QDomElement lessonElem = doc.createElement(QStringLiteral("lesson"));
-        QDomElement idElem = doc.createElement(QStringLiteral("id"));
-        QDomElement titleElem = doc.createElement(QStringLiteral("title"));
-        QDomElement newCharactersElem = doc.createElement(QStringLiteral("newCharacters"));
-        QDomElement textElem = doc.createElement(QStringLiteral("text"));
-
-        idElem.appendChild(doc.createTextNode(lesson->id()));
-        titleElem.appendChild(doc.createTextNode(lesson->title()));
-        newCharactersElem.appendChild(doc.createTextNode(lesson->newCharacters()));
-        textElem.appendChild(doc.createTextNode(lesson->text()));
-
-        lessonElem.appendChild(idElem);
-        lessonElem.appendChild(titleElem);
-        lessonElem.appendChild(newCharactersElem);
-        lessonElem.appendChild(textElem);
-        lessonsElem.appendChild(lessonElem);
+        writer.writeStartElement(QStringLiteral("lesson"));
+        writer.writeTextElement(QStringLiteral("id"), lesson->id());
+        writer.writeTextElement(QStringLiteral("title"), lesson->title());
+        writer.writeTextElement(QStringLiteral("newCharacters"), lesson->newCharacters());
+        writer.writeTextElement(QStringLiteral("text"), lesson->text());
+        writer.writeEndElement();
     }
 
-    root.appendChild(idElem);
-    root.appendChild(titleElem);
-    root.appendChild(descriptionElem);
-    root.appendChild(keyboardLayoutElem);
-    root.appendChild(lessonsElem);
+    writer.writeEndElement();
+    writer.writeEndElement();
+    writer.writeEndDocument();
 
-    QFile file;
-
-    file.setFileName(path);
-
-    if (!file.open(QIODevice::WriteOnly))
+    if (writer.hasError() || !file.commit())
     {
-        qWarning() << "can't open:" << file.fileName();
+        qWarning() << "can't write:" << file.fileName() << file.errorString();
         return false;
     }
 
-    file.write(doc.toByteArray());
     return true;
 }
 
@@ -425,6 +482,35 @@ QDomDocument ResourceDataAccess::getDomDocument(QFile &file, QXmlSchema &schema)
     return doc;
 }
 
+QString ResourceDataAccess::validateResourceFile(const ResourceFile& resourceFile)
+{
+    QHash<QString, QXmlSchema>& schemata = threadSchemata.localData();
+
+    if (!schemata.contains(resourceFile.schemaName))
+    {
+        schemata.insert(resourceFile.schemaName, loadXmlSchema(resourceFile.schemaName));
+    }
+
+    QXmlSchema& schema = schemata[resourceFile.schemaName];
+
+    if (!schema.isValid())
+        return QStringLiteral("schema %1 is invalid").arg(resourceFile.schemaName);
+
+    QFile file(resourceFile.path);
+
+    if (!file.open(QIODevice::ReadOnly))
+        return QStringLiteral("can't open file");
+
+    ValidationMessageHandler messageHandler;
+    QXmlSchemaValidator validator(schema);
+    validator.setMessageHandler(&messageHandler);
+
+    if (!validator.validate(&file, QUrl::fromLocalFile(resourceFile.path)))
+        return messageHandler.message().isEmpty()? QStringLiteral("validation failed"): messageHandler.message();
+
+    return QString();
+}
+
 bool ResourceDataAccess::openResourceFile(const QString &relPath, QFile& file)
 {
     QString path = QStandardPaths::locate(QStandardPaths::DataLocation, relPath);
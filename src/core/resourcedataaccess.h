@@ -20,28 +20,45 @@
 
 #include <QObject>
 
+class QThread;
 class QXmlSchema;
 class QDomDocument;
 class QFile;
 class DataIndex;
+class Resource;
 class KeyboardLayout;
 class Course;
+struct KeyboardLayoutData;
 
 class ResourceDataAccess : public QObject
 {
     Q_OBJECT
 public:
     explicit ResourceDataAccess(QObject *parent = 0);
-    Q_INVOKABLE bool fillDataIndex(DataIndex* target);
+    Q_INVOKABLE bool fillDataIndex(DataIndex* target, bool validateResources = false);
+    /**
+     * Creates a data index of the built-in resources and validates them.
+     * The index is moved to @p targetThread and is invalid if the
+     * resources couldn't be listed. Safe to call from worker threads.
+     */
+    static DataIndex* loadDataIndex(QThread* targetThread);
     Q_INVOKABLE bool loadKeyboardLayout(const QString& path, KeyboardLayout* target);
+    bool loadKeyboardLayoutData(const QString& path, KeyboardLayoutData* target);
     Q_INVOKABLE bool storeKeyboardLayout(const QString& path, KeyboardLayout* source);
     Q_INVOKABLE bool loadCourse(const QString& path, Course* target);
     Q_INVOKABLE bool storeCourse(const QString& path, Course* source);
 
 private:
-    QXmlSchema loadXmlSchema(const QString& name);
-    QDomDocument getDomDocument(QFile& file, QXmlSchema& schema);
-    bool openResourceFile(const QString& relPath, QFile& file);
+    struct ResourceFile
+    {
+        Resource* resource;
+        QString path;
+        QString schemaName;
+    };
+    static QXmlSchema loadXmlSchema(const QString& name);
+    static QDomDocument getDomDocument(QFile& file, QXmlSchema& schema);
+    static bool openResourceFile(const QString& relPath, QFile& file);
+    static QString validateResourceFile(const ResourceFile& resourceFile);
 };
 
 #endif // RESOURCEDATAACCESS_H
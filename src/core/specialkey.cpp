@@ -51,34 +51,39 @@ QString SpecialKey::typeStr() const
 }
 
 void SpecialKey::setTypeStr(const QString &typeStr)
+{
+    m_type = typeFromStr(typeStr);
+}
+
+SpecialKey::Type SpecialKey::typeFromStr(const QString& typeStr)
 {
     if (typeStr == QLatin1String("tab"))
     {
-        m_type = SpecialKey::Tab;
+        return SpecialKey::Tab;
     }
     else if (typeStr == QLatin1String("capslock"))
     {
-        m_type = SpecialKey::Capslock;
+        return SpecialKey::Capslock;
     }
     else if (typeStr == QLatin1String("shift"))
     {
-        m_type = SpecialKey::Shift;
+        return SpecialKey::Shift;
     }
     else if (typeStr == QLatin1String("backspace"))
     {
-        m_type = SpecialKey::Backspace;
+        return SpecialKey::Backspace;
     }
     else if (typeStr == QLatin1String("return"))
     {
-        m_type = SpecialKey::Return;
+        return SpecialKey::Return;
     }
     else if (typeStr == QLatin1String("space"))
     {
-        m_type = SpecialKey::Space;
+        return SpecialKey::Space;
     }
     else
     {
-        m_type = SpecialKey::Other;
+        return SpecialKey::Other;
     }
 }
 
@@ -43,6 +43,7 @@ public:
     Q_INVOKABLE QString keyType() const override;
     QString typeStr() const;
     void setTypeStr(const QString& typeStr);
+    static Type typeFromStr(const QString& typeStr);
     Type type() const;
     void setType(Type type);
     QString modifierId() const;
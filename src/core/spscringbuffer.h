@@ -0,0 +1,82 @@
+/*
+ *  Copyright 2026  Sebastian Gottfried <sebastian.gottfried@posteo.de>
+ *
+ *  This program is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU General Public License as
+ *  published by the Free Software Foundation; either version 2 of
+ *  the License, or (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef SPSCRINGBUFFER_H
+#define SPSCRINGBUFFER_H
+
+#include <QAtomicInt>
+
+/**
+ * Fixed capacity queue for exactly one producer and one consumer thread.
+ * Neither push() nor pop() allocate or lock. One slot always stays unused
+ * to tell a full buffer from an empty one.
+ */
+template <typename T, int Capacity>
+class SpscRingBuffer
+{
+public:
+    SpscRingBuffer():
+        m_head(0),
+        m_tail(0)
+    {
+    }
+
+    // producer side, returns false if the buffer is full
+    bool push(const T& value)
+    {
+        const int head = m_head.loadAcquire();
+        const int next = (head + 1) % Capacity;
+
+        if (next == m_tail.loadAcquire())
+            return false;
+
+        m_items[head] = value;
+        m_head.storeRelease(next);
+        return true;
+    }
+
+    // consumer side, returns false if the buffer is empty
+    bool pop(T& value)
+    {
+        const int tail = m_tail.loadAcquire();
+
+        if (tail == m_head.loadAcquire())
+            return false;
+
+        value = m_items[tail];
+        m_tail.storeRelease((tail + 1) % Capacity);
+        return true;
+    }
+
+    // consumer side
+    void clear()
+    {
+        m_tail.storeRelease(m_head.loadAcquire());
+    }
+
+    bool isEmpty() const
+    {
+        return m_tail.loadAcquire() == m_head.loadAcquire();
+    }
+
+private:
+    T m_items[Capacity];
+    QAtomicInt m_head;
+    QAtomicInt m_tail;
+};
+
+#endif // SPSCRINGBUFFER_H
@@ -0,0 +1,394 @@
+/*
+ *  Copyright 2026  Sebastian Gottfried <sebastian.gottfried@posteo.de>
+ *
+ *  This program is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU General Public License as
+ *  published by the Free Software Foundation; either version 2 of
+ *  the License, or (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "textkernels.h"
+
+#include <QtAlgorithms>
+
+#include "characterset.h"
+
+#if defined(Q_PROCESSOR_X86) && defined(Q_CC_GNU)
+#define TEXTKERNELS_X86
+#include <immintrin.h>
+#endif
+
+namespace
+{
+    const ushort carriageReturn = 0x000d;
+    const ushort lineFeed = 0x000a;
+    const ushort paragraphSeparator = 0x2029;
+    const ushort space = 0x0020;
+
+    int mismatchScalar(const ushort* first, const ushort* second, int length)
+    {
+        int i = 0;
+
+        while (i < length && first[i] == second[i])
+        {
+            i++;
+        }
+
+        return i;
+    }
+
+    void replaceLineBreaksScalar(ushort* text, int length)
+    {
+        for (int i = 0; i < length; i++)
+        {
+            const ushort c = text[i];
+
+            if (c == carriageReturn || c == lineFeed || c == paragraphSeparator)
+            {
+                text[i] = space;
+            }
+        }
+    }
+
+    uint codePointAt(const ushort* text, int length, int index)
+    {
+        const ushort c = text[index];
+
+        if (QChar::isHighSurrogate(c) && index + 1 < length && QChar::isLowSurrogate(text[index + 1]))
+            return QChar::surrogateToUcs4(c, text[index + 1]);
+
+        return c;
+    }
+
+    // checks the code points starting before end, on a miss i is left at it
+    bool containsCodePoints(const ushort* text, int length, const CharacterSet& set, int& i, int end)
+    {
+        while (i < end)
+        {
+            const uint codePoint = codePointAt(text, length, i);
+
+            if (!set.contains(codePoint))
+                return false;
+
+            i += QChar::requiresSurrogates(codePoint)? 2: 1;
+        }
+
+        return true;
+    }
+
+    int indexOfMissingScalar(const ushort* text, int length, const CharacterSet& set)
+    {
+        int i = 0;
+        containsCodePoints(text, length, set, i, length);
+        return i;
+    }
+
+#ifdef TEXTKERNELS_X86
+    __attribute__((target("sse2")))
+    int mismatchSse2(const ushort* first, const ushort* second, int length)
+    {
+        int i = 0;
+
+        for (; i + 8 <= length; i += 8)
+        {
+            const __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(first + i));
+            const __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(second + i));
+            const uint mask = uint(_mm_movemask_epi8(_mm_cmpeq_epi16(a, b)));
+
+            if (mask != 0xffff)
+                return i + int(qCountTrailingZeroBits(~mask)) / 2;
+        }
+
+        return i + mismatchScalar(first + i, second + i, length - i);
+    }
+
+    __attribute__((target("avx2")))
+    int mismatchAvx2(const ushort* first, const ushort* second, int length)
+    {
+        int i = 0;
+
+        for (; i + 16 <= length; i += 16)
+        {
+            const __m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(first + i));
+            const __m256i b = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(second + i));
+            const uint mask = uint(_mm256_movemask_epi8(_mm256_cmpeq_epi16(a, b)));
+
+            if (mask != 0xffffffff)
+                return i + int(qCountTrailingZeroBits(~mask)) / 2;
+        }
+
+        return i + mismatchSse2(first + i, second + i, length - i);
+    }
+
+    __attribute__((target("sse2")))
+    void replaceLineBreaksSse2(ushort* text, int length)
+    {
+        const __m128i carriageReturns = _mm_set1_epi16(short(carriageReturn));
+        const __m128i lineFeeds = _mm_set1_epi16(short(lineFeed));
+        const __m128i paragraphSeparators = _mm_set1_epi16(short(paragraphSeparator));
+        const __m128i spaces = _mm_set1_epi16(short(space));
+        int i = 0;
+
+        for (; i + 8 <= length; i += 8)
+        {
+            __m128i* const chunk = reinterpret_cast<__m128i*>(text + i);
+            const __m128i v = _mm_loadu_si128(chunk);
+            const __m128i lineBreaks = _mm_or_si128(
+                        _mm_or_si128(_mm_cmpeq_epi16(v, carriageReturns), _mm_cmpeq_epi16(v, lineFeeds)),
+                        _mm_cmpeq_epi16(v, paragraphSeparators));
+
+            if (_mm_movemask_epi8(lineBreaks) == 0)
+                continue;
+
+            _mm_storeu_si128(chunk, _mm_or_si128(_mm_andnot_si128(lineBreaks, v), _mm_and_si128(lineBreaks, spaces)));
+        }
+
+        replaceLineBreaksScalar(text + i, length - i);
+    }
+
+    __attribute__((target("avx2")))
+    void replaceLineBreaksAvx2(ushort* text, int length)
+    {
+        const __m256i carriageReturns = _mm256_set1_epi16(short(carriageReturn));
+        const __m256i lineFeeds = _mm256_set1_epi16(short(lineFeed));
+        const __m256i paragraphSeparators = _mm256_set1_epi16(short(paragraphSeparator));
+        const __m256i spaces = _mm256_set1_epi16(short(space));
+        int i = 0;
+
+        for (; i + 16 <= length; i += 16)
+        {
+            __m256i* const chunk = reinterpret_cast<__m256i*>(text + i);
+            const __m256i v = _mm256_loadu_si256(chunk);
+            const __m256i lineBreaks = _mm256_or_si256(
+                        _mm256_or_si256(_mm256_cmpeq_epi16(v, carriageReturns), _mm256_cmpeq_epi16(v, lineFeeds)),
+                        _mm256_cmpeq_epi16(v, paragraphSeparators));
+
+            if (_mm256_movemask_epi8(lineBreaks) == 0)
+                continue;
+
+            _mm256_storeu_si256(chunk, _mm256_blendv_epi8(v, spaces, lineBreaks));
+        }
+
+        replaceLineBreaksSse2(text + i, length - i);
+    }
+
+    // the ASCII part of a character set as nibble lookup tables: bit n of
+    // byte l is set if the set contains the character 16 * n + l
+    struct AsciiLookup
+    {
+        explicit AsciiLookup(const CharacterSet& set):
+            rows()
+        {
+            const quint64 words[] = {set.bitmapWord(0), set.bitmapWord(1)};
+
+            for (int c = 0; c < 128; c++)
+            {
+                if ((words[c / 64] >> (c % 64)) & 1)
+                {
+                    rows[c % 16] |= uchar(1 << (c / 16));
+                }
+            }
+        }
+
+        uchar rows[16];
+    };
+
+    __attribute__((target("ssse3")))
+    inline __m128i asciiMisses(__m128i bytes, __m128i rows)
+    {
+        const __m128i columns = _mm_setr_epi8(1, 2, 4, 8, 16, 32, 64, char(128), 0, 0, 0, 0, 0, 0, 0, 0);
+        const __m128i lowNibbles = _mm_set1_epi8(0x0f);
+        const __m128i lows = _mm_and_si128(bytes, lowNibbles);
+        const __m128i highs = _mm_and_si128(_mm_srli_epi16(bytes, 4), lowNibbles);
+        const __m128i found = _mm_and_si128(_mm_shuffle_epi8(rows, lows), _mm_shuffle_epi8(columns, highs));
+        return _mm_cmpeq_epi8(found, _mm_setzero_si128());
+    }
+
+    __attribute__((target("ssse3")))
+    int indexOfMissingSsse3(const ushort* text, int length, const CharacterSet& set)
+    {
+        const AsciiLookup lookup(set);
+        const __m128i rows = _mm_loadu_si128(reinterpret_cast<const __m128i*>(lookup.rows));
+        const __m128i nonAscii = _mm_set1_epi16(short(0xff80));
+        int i = 0;
+
+        while (i + 8 <= length)
+        {
+            const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(text + i));
+
+            if (_mm_movemask_epi8(_mm_cmpeq_epi16(_mm_and_si128(v, nonAscii), _mm_setzero_si128())) != 0xffff)
+            {
+                if (!containsCodePoints(text, length, set, i, i + 8))
+                    return i;
+
+                continue;
+            }
+
+            const uint misses = uint(_mm_movemask_epi8(asciiMisses(_mm_packus_epi16(v, v), rows))) & 0xff;
+
+            if (misses)
+                return i + int(qCountTrailingZeroBits(misses));
+
+            i += 8;
+        }
+
+        containsCodePoints(text, length, set, i, length);
+        return i;
+    }
+
+    __attribute__((target("avx2")))
+    int indexOfMissingAvx2(const ushort* text, int length, const CharacterSet& set)
+    {
+        const AsciiLookup lookup(set);
+        const __m128i rows = _mm_loadu_si128(reinterpret_cast<const __m128i*>(lookup.rows));
+        const __m256i nonAscii = _mm256_set1_epi16(short(0xff80));
+        int i = 0;
+
+        while (i + 16 <= length)
+        {
+            const __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(text + i));
+
+            if (!_mm256_testz_si256(v, nonAscii))
+            {
+                if (!containsCodePoints(text, length, set, i, i + 16))
+                    return i;
+
+                continue;
+            }
+
+            // packing works per 128 bit lane, gather both halves in the lower one
+            const __m128i bytes = _mm256_castsi256_si128(_mm256_permute4x64_epi64(_mm256_packus_epi16(v, v), 0x08));
+            const uint misses = uint(_mm_movemask_epi8(asciiMisses(bytes, rows)));
+
+            if (misses)
+                return i + int(qCountTrailingZeroBits(misses));
+
+            i += 16;
+        }
+
+        return i + indexOfMissingSsse3(text + i, length - i, set);
+    }
+#endif
+
+    typedef int (*MismatchFunction)(const ushort*, const ushort*, int);
+    typedef void (*ReplaceLineBreaksFunction)(ushort*, int);
+    typedef int (*IndexOfMissingFunction)(const ushort*, int, const CharacterSet&);
+
+    struct Kernels
+    {
+        Kernels()
+        {
+#ifdef TEXTKERNELS_X86
+            __builtin_cpu_init();
+#endif
+
+            if (!select(TextKernels::Avx2) && !select(TextKernels::Sse2))
+            {
+                select(TextKernels::Scalar);
+            }
+        }
+
+        bool select(TextKernels::Implementation implementation)
+        {
+            switch (implementation)
+            {
+            case TextKernels::Scalar:
+                mismatch = mismatchScalar;
+                replaceLineBreaks = replaceLineBreaksScalar;
+                indexOfMissing = indexOfMissingScalar;
+                break;
+#ifdef TEXTKERNELS_X86
+            case TextKernels::Sse2:
+                if (!__builtin_cpu_supports("sse2"))
+                    return false;
+
+                mismatch = mismatchSse2;
+                replaceLineBreaks = replaceLineBreaksSse2;
+                indexOfMissing = __builtin_cpu_supports("ssse3")? indexOfMissingSsse3: indexOfMissingScalar;
+                break;
+            case TextKernels::Avx2:
+                if (!__builtin_cpu_supports("avx2"))
+                    return false;
+
+                mismatch = mismatchAvx2;
+                replaceLineBreaks = replaceLineBreaksAvx2;
+                indexOfMissing = indexOfMissingAvx2;
+                break;
+#endif
+            default:
+                return false;
+            }
+
+            this->implementation = implementation;
+            return true;
+        }
+
+        TextKernels::Implementation implementation;
+        MismatchFunction mismatch;
+        ReplaceLineBreaksFunction replaceLineBreaks;
+        IndexOfMissingFunction indexOfMissing;
+    };
+
+    Kernels& kernels()
+    {
+        static Kernels kernels;
+        return kernels;
+    }
+}
+
+TextKernels::Implementation TextKernels::implementation()
+{
+    return kernels().implementation;
+}
+
+bool TextKernels::setImplementation(Implementation implementation)
+{
+    return kernels().select(implementation);
+}
+
+int TextKernels::mismatch(const QChar* first, const QChar* second, int length)
+{
+    return kernels().mismatch(reinterpret_cast<const ushort*>(first), reinterpret_cast<const ushort*>(second), length);
+}
+
+void TextKernels::replaceLineBreaks(QString& text)
+{
+    if (text.isEmpty())
+        return;
+
+    kernels().replaceLineBreaks(reinterpret_cast<ushort*>(text.data()), text.length());
+}
+
+int TextKernels::indexOfMissing(const QChar* text, int length, const CharacterSet& set)
+{
+    return kernels().indexOfMissing(reinterpret_cast<const ushort*>(text), length, set);
+}
+
+void TextKernels::collectDistinct(const QChar* text, int length, CharacterSet& seen, QString& distinct)
+{
+    const ushort* const data = reinterpret_cast<const ushort*>(text);
+    const IndexOfMissingFunction indexOfMissing = kernels().indexOfMissing;
+    int i = 0;
+
+    while (true)
+    {
+        i += indexOfMissing(data + i, length - i, seen);
+
+        if (i >= length)
+            break;
+
+        const uint codePoint = codePointAt(data, length, i);
+        const int codePointLength = QChar::requiresSurrogates(codePoint)? 2: 1;
+        seen.insert(codePoint);
+        distinct.append(text + i, codePointLength);
+        i += codePointLength;
+    }
+}
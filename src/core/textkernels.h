@@ -0,0 +1,77 @@
+/*
+ *  Copyright 2026  Sebastian Gottfried <sebastian.gottfried@posteo.de>
+ *
+ *  This program is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU General Public License as
+ *  published by the Free Software Foundation; either version 2 of
+ *  the License, or (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef TEXTKERNELS_H
+#define TEXTKERNELS_H
+
+#include <QChar>
+#include <QString>
+
+class CharacterSet;
+
+/**
+ * Vectorized loops over UTF-16 text.
+ *
+ * On x86 the SSE2 or AVX2 variant is picked at runtime depending on the
+ * CPU, everywhere else a plain loop is used. All variants give the same
+ * results. The character set lookups of the SSE2 variant need SSSE3 and
+ * fall back to the plain loop without it.
+ */
+namespace TextKernels
+{
+    enum Implementation
+    {
+        Scalar,
+        Sse2,
+        Avx2
+    };
+
+    Implementation implementation();
+
+    /**
+     * Switches all kernels to @p implementation, to compare the variants
+     * with each other. Returns false if the CPU doesn't support it.
+     */
+    bool setImplementation(Implementation implementation);
+
+    /**
+     * Returns the index of the first position at which @p first and
+     * @p second differ, or @p length if they are equal.
+     */
+    int mismatch(const QChar* first, const QChar* second, int length);
+
+    /**
+     * Replaces carriage returns, line feeds and paragraph separators in
+     * @p text with spaces.
+     */
+    void replaceLineBreaks(QString& text);
+
+    /**
+     * Returns the index of the first code point of @p text which isn't in
+     * @p set, or @p length if all of them are.
+     */
+    int indexOfMissing(const QChar* text, int length, const CharacterSet& set);
+
+    /**
+     * Appends the code points of @p text which aren't in @p seen yet to
+     * @p distinct, in the order of their first occurrence, and adds them
+     * to @p seen.
+     */
+    void collectDistinct(const QChar* text, int length, CharacterSet& seen, QString& distinct);
+}
+
+#endif // TEXTKERNELS_H
@@ -17,7 +17,7 @@
 
 #include "trainingstats.h"
 
-#include <QDateTime>
+#include <QQuickWindow>
 #include <QTimer>
 
 TrainingStats::TrainingStats(QObject* parent) :
@@ -25,11 +25,15 @@ TrainingStats::TrainingStats(QObject* parent) :
     m_timeIsRunning(false),
     m_charactersTyped(0),
     m_elapsedTime(0),
+    m_elapsedNsecs(0),
     m_errorCount(0),
     m_isValid(true),
     m_startTime(0),
-    m_updateTimer(new QTimer(this))
+    m_updateTimer(new QTimer(this)),
+    m_pendingChanges(0),
+    m_frameRequested(false)
 {
+    m_clock.start();
     connect(m_updateTimer, &QTimer::timeout, this, &TrainingStats::update);
 }
 
@@ -43,7 +47,7 @@ void TrainingStats::setCharactersTyped(int charactesTyped)
     if(charactesTyped != m_charactersTyped)
     {
         m_charactersTyped = charactesTyped;
-        emit statsChanged();
+        notifyChanged(CharactersTypedChange);
     }
 }
 
@@ -59,7 +63,8 @@ void TrainingStats::setElapsedTime(const QTime& elapsedTime)
     if(msec != m_elapsedTime)
     {
         m_elapsedTime = msec;
-        emit statsChanged();
+        m_elapsedNsecs = msec * 1000000;
+        notifyChanged(ElapsedTimeChange);
     }
 }
 
@@ -68,7 +73,8 @@ void TrainingStats::setElapsedTime(const quint64& msec)
     if(msec != m_elapsedTime)
     {
         m_elapsedTime = msec;
-        emit statsChanged();
+        m_elapsedNsecs = msec * 1000000;
+        notifyChanged(ElapsedTimeChange);
     }
 }
 
@@ -82,7 +88,7 @@ void TrainingStats::setErrorCount(int errorCount)
     if(errorCount != m_errorCount)
     {
         m_errorCount = errorCount;
-        emit statsChanged();
+        notifyChanged(ErrorCountChange);
     }
 }
 
@@ -99,12 +105,12 @@ void TrainingStats::setIsValid(bool isValid)
         emit isValidChanged();
     }
 }
-QMap< QString, int > TrainingStats::errorMap() const
+const CharacterErrorMap& TrainingStats::errorMap() const
 {
     return m_errorMap;
 }
 
-void TrainingStats::setErrorMap(const QMap< QString, int >& errorMap)
+void TrainingStats::setErrorMap(const CharacterErrorMap& errorMap)
 {
     m_errorMap = errorMap;
     emit errorsChanged();
@@ -115,33 +121,78 @@ bool TrainingStats::timeIsRunning() const
     return m_timeIsRunning;
 }
 
+QQuickWindow* TrainingStats::window() const
+{
+    return m_window;
+}
+
+void TrainingStats::setWindow(QQuickWindow* window)
+{
+    if (window != m_window)
+    {
+        if (m_window)
+        {
+            m_window->disconnect(this);
+        }
+
+        m_window = window;
+        m_frameRequested = false;
+
+        if (m_window)
+        {
+            connect(m_window, &QQuickWindow::afterAnimating, this, &TrainingStats::emitPendingChanges);
+            connect(m_window, &QWindow::activeChanged, this, &TrainingStats::updateTimerState);
+            connect(m_window, &QWindow::visibleChanged, this, &TrainingStats::updateTimerState);
+        }
+
+        emitPendingChanges();
+        updateTimerState();
+        emit windowChanged();
+    }
+}
+
 void TrainingStats::startTraining()
 {
     if (!m_timeIsRunning)
     {
         m_timeIsRunning = true;
-        m_startTime = QDateTime::currentMSecsSinceEpoch() - m_elapsedTime;
+        m_startTime = m_clock.nsecsElapsed() - m_elapsedNsecs;
+        notifyChanged(TimeIsRunningChange);
         update();
     }
 }
 
 void TrainingStats::stopTraining()
 {
+    int changes = drainKeystrokes();
+
     if (m_timeIsRunning)
     {
+        // take the time up to the stop, not just up to the last poll
         m_timeIsRunning = false;
-        update();
+        m_elapsedNsecs = m_clock.nsecsElapsed() - m_startTime;
+        m_elapsedTime = m_elapsedNsecs / 1000000;
+        changes |= TimeIsRunningChange | ElapsedTimeChange;
+        updateTimerState();
+    }
+
+    if (changes)
+    {
+        notifyChanged(changes);
     }
 }
 
 void TrainingStats::reset()
 {
     stopTraining();
+    m_keystrokes.clear();
     m_charactersTyped = 0;
     m_elapsedTime = 0;
+    m_elapsedNsecs = 0;
     m_errorCount = 0;
     m_errorMap.clear();
-    statsChanged();
+    notifyChanged(CharactersTypedChange | ElapsedTimeChange | ErrorCountChange);
+    emit errorsChanged();
 }
 
 void TrainingStats::logCharacter(const QString &character, EventType type)
@@ -149,21 +200,35 @@ void TrainingStats::logCharacter(const QString &character, EventType type)
     if (type == TrainingStats::CorrectCharacter)
     {
         m_charactersTyped++;
+        notifyChanged(CharactersTypedChange);
     }
     else
     {
         m_errorCount++;
-        if (m_errorMap.contains(character))
-        {
-            m_errorMap[character]++;
-        }
-        else
+        notifyChanged(ErrorCountChange);
+
+        if (!character.isEmpty())
         {
-            m_errorMap[character] = 1;
+            m_errorMap.addError(character.at(0));
+            emit characterErrorsChanged(character.at(0));
         }
+    }
+}
+
+void TrainingStats::recordKeystroke(QChar expected, QChar typed, EventType type)
+{
+    const Keystroke keystroke = {m_clock.nsecsElapsed(), expected, typed, type};
 
-        emit errorsChanged();
+    if (!m_keystrokes.push(keystroke))
+    {
+        // the input path and the consumer both run on the GUI thread, so
+        // room can be made right away
+        m_pendingChanges |= drainKeystrokes();
+        m_keystrokes.push(keystroke);
     }
+
+    // the buffer is drained together with the next frame
+    notifyChanged(KeystrokesChange);
 }
 
 float TrainingStats::accuracy()
@@ -188,12 +253,120 @@ int TrainingStats::charactersPerMinute()
 
 void TrainingStats::update()
 {
-    m_updateTimer->stop();
+    int changes = drainKeystrokes();
+
     if (m_timeIsRunning)
     {
-        qint64 now = QDateTime::currentMSecsSinceEpoch();
-        m_elapsedTime = now - m_startTime;
-        m_updateTimer->start(200);
+        m_elapsedNsecs = m_clock.nsecsElapsed() - m_startTime;
+        m_elapsedTime = m_elapsedNsecs / 1000000;
+        changes |= ElapsedTimeChange;
+    }
+
+    if (changes)
+    {
+        notifyChanged(changes);
+    }
+
+    updateTimerState();
+}
+
+void TrainingStats::updateTimerState()
+{
+    // the elapsed time is taken from the clock, so nothing is lost while
+    // the meters aren't visible
+    if (m_timeIsRunning && windowIsShown())
+    {
+        if (!m_updateTimer->isActive())
+        {
+            m_updateTimer->start(200);
+        }
+    }
+    else
+    {
+        m_updateTimer->stop();
     }
-    emit statsChanged();
+}
+
+void TrainingStats::notifyChanged(int changes)
+{
+    m_pendingChanges |= changes;
+
+    if (!m_window || !m_window->isExposed())
+    {
+        // no frame is going to come, don't hold the changes back
+        emitPendingChanges();
+        return;
+    }
+
+    if (!m_frameRequested)
+    {
+        m_frameRequested = true;
+        m_window->update();
+    }
+}
+
+void TrainingStats::emitPendingChanges()
+{
+    const int changes = m_pendingChanges | drainKeystrokes();
+    m_pendingChanges = 0;
+    m_frameRequested = false;
+
+    if (changes & CharactersTypedChange)
+    {
+        emit charactersTypedChanged();
+    }
+
+    if (changes & ElapsedTimeChange)
+    {
+        emit elapsedTimeChanged();
+    }
+
+    if (changes & ErrorCountChange)
+    {
+        emit errorCountChanged();
+    }
+
+    if (changes & (CharactersTypedChange | ErrorCountChange))
+    {
+        emit accuracyChanged();
+    }
+
+    if (changes & (CharactersTypedChange | ElapsedTimeChange))
+    {
+        emit charactersPerMinuteChanged();
+    }
+
+    if (changes & TimeIsRunningChange)
+    {
+        emit timeIsRunningChanged();
+    }
+}
+
+bool TrainingStats::windowIsShown() const
+{
+    return !m_window || (m_window->isVisible() && m_window->isActive());
+}
+
+int TrainingStats::drainKeystrokes()
+{
+    Keystroke keystroke;
+    int changes = 0;
+
+    while (m_keystrokes.pop(keystroke))
+    {
+        if (keystroke.type == TrainingStats::CorrectCharacter)
+        {
+            m_charactersTyped++;
+            changes |= CharactersTypedChange;
+        }
+        else
+        {
+            m_errorCount++;
+            m_errorMap.addError(keystroke.expected);
+            changes |= ErrorCountChange;
+            emit characterErrorsChanged(keystroke.expected);
+        }
+    }
+
+    return changes;
 }
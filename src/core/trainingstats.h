@@ -20,23 +20,29 @@
 
 #include <QObject>
 #include <QChar>
+#include <QElapsedTimer>
 #include <QTime>
-#include <QMap>
+#include <QPointer>
 #include <QString>
 
+#include "charactererrormap.h"
+#include "spscringbuffer.h"
+
+class QQuickWindow;
 class QTimer;
 
 class TrainingStats : public QObject
 {
     Q_OBJECT
     Q_ENUMS(EventType)
-    Q_PROPERTY(int charactesTyped READ charactesTyped WRITE setCharactersTyped NOTIFY statsChanged)
-    Q_PROPERTY(QTime elapsedTime READ elapsedTime WRITE setElapsedTime NOTIFY statsChanged)
-    Q_PROPERTY(int errorCount READ errorCount NOTIFY statsChanged)
+    Q_PROPERTY(int charactesTyped READ charactesTyped WRITE setCharactersTyped NOTIFY charactersTypedChanged)
+    Q_PROPERTY(QTime elapsedTime READ elapsedTime WRITE setElapsedTime NOTIFY elapsedTimeChanged)
+    Q_PROPERTY(int errorCount READ errorCount NOTIFY errorCountChanged)
     Q_PROPERTY(bool isValid READ isValid WRITE setIsValid NOTIFY isValidChanged)
-    Q_PROPERTY(float accuracy READ accuracy NOTIFY statsChanged)
-    Q_PROPERTY(int charactersPerMinute READ charactersPerMinute NOTIFY statsChanged)
-    Q_PROPERTY(bool timeIsRunning READ timeIsRunning NOTIFY statsChanged)
+    Q_PROPERTY(float accuracy READ accuracy NOTIFY accuracyChanged)
+    Q_PROPERTY(int charactersPerMinute READ charactersPerMinute NOTIFY charactersPerMinuteChanged)
+    Q_PROPERTY(bool timeIsRunning READ timeIsRunning NOTIFY timeIsRunningChanged)
+    Q_PROPERTY(QQuickWindow* window READ window WRITE setWindow NOTIFY windowChanged)
 
 public:
     enum EventType {
@@ -44,6 +50,15 @@ public:
         IncorrectCharacter
     };
 
+    struct Keystroke
+    {
+        // nanoseconds since the creation of the stats object
+        qint64 timestamp;
+        QChar expected;
+        QChar typed;
+        EventType type;
+    };
+
     explicit TrainingStats(QObject* parent = 0);
     int charactesTyped() const;
     void setCharactersTyped(int charactesTyped);
@@ -54,31 +69,60 @@ public:
     void setErrorCount(int errorCount);
     bool isValid() const;
     void setIsValid(bool isValid);
-    QMap<QString, int> errorMap() const;
-    void setErrorMap(const QMap<QString, int>& errorMap);
+    const CharacterErrorMap& errorMap() const;
+    void setErrorMap(const CharacterErrorMap& errorMap);
     bool timeIsRunning() const;
+    QQuickWindow* window() const;
+    void setWindow(QQuickWindow* window);
     Q_INVOKABLE void startTraining();
     Q_INVOKABLE void stopTraining();
     Q_INVOKABLE void reset();
     Q_INVOKABLE void logCharacter(const QString &character, EventType type);
+    void recordKeystroke(QChar expected, QChar typed, EventType type);
     float accuracy();
     int charactersPerMinute();
 
 signals:
-    void statsChanged();
+    void charactersTypedChanged();
+    void elapsedTimeChanged();
+    void errorCountChanged();
+    void accuracyChanged();
+    void charactersPerMinuteChanged();
+    void timeIsRunningChanged();
     void isValidChanged();
     void errorsChanged();
+    void characterErrorsChanged(QChar character);
+    void windowChanged();
 
 private:
+    enum Change
+    {
+        CharactersTypedChange = 0x1,
+        ElapsedTimeChange = 0x2,
+        ErrorCountChange = 0x4,
+        TimeIsRunningChange = 0x8,
+        KeystrokesChange = 0x10
+    };
     Q_SLOT void update();
+    Q_SLOT void updateTimerState();
+    Q_SLOT void emitPendingChanges();
+    void notifyChanged(int changes);
+    int drainKeystrokes();
+    bool windowIsShown() const;
     bool m_timeIsRunning;
     int m_charactersTyped;
     quint64 m_elapsedTime;
+    qint64 m_elapsedNsecs;
     int m_errorCount;
     bool m_isValid;
-    QMap<QString, int> m_errorMap;
-    quint64 m_startTime;
+    CharacterErrorMap m_errorMap;
+    qint64 m_startTime;
     QTimer* m_updateTimer;
+    QElapsedTimer m_clock;
+    QPointer<QQuickWindow> m_window;
+    int m_pendingChanges;
+    bool m_frameRequested;
+    SpscRingBuffer<Keystroke, 1024> m_keystrokes;
 };
 
 #endif // TRAININGSTATS_H
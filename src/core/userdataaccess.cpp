@@ -18,6 +18,7 @@
 #include "userdataaccess.h"
 
 #include <QDebug>
+#include <QThread>
 #include <QVariant>
 #include <QSqlDatabase>
 #include <QSqlQuery>
@@ -97,6 +98,20 @@ bool UserDataAccess::fillDataIndex(DataIndex* target)
     return true;
 }
 
+DataIndex* UserDataAccess::loadDataIndex(QThread* targetThread)
+{
+    DataIndex* dataIndex = new DataIndex();
+
+    {
+        UserDataAccess userDataAccess;
+        dataIndex->setIsValid(userDataAccess.fillDataIndex(dataIndex));
+    }
+
+    releaseThreadDatabase();
+    dataIndex->moveToThread(targetThread);
+    return dataIndex;
+}
+
 bool UserDataAccess::loadCourse(const QString& id, Course* target)
 {
     target->setIsValid(false);
@@ -131,6 +146,7 @@ bool UserDataAccess::loadCourse(const QString& id, Course* target)
     target->setDescription(courseQuery.value(1).toString());
     target->setKeyboardLayoutName(courseQuery.value(2).toString());
     target->setKind(Course::SequentialCourse);
+    target->beginBatch();
     target->clearLessons();
 
     QSqlQuery lessonsQuery(db);
@@ -143,6 +159,7 @@ bool UserDataAccess::loadCourse(const QString& id, Course* target)
     {
         qWarning() << lessonsQuery.lastError().text();
         raiseError(lessonsQuery.lastError());
+        target->endBatch();
         return false;
     }
 
@@ -158,6 +175,7 @@ bool UserDataAccess::loadCourse(const QString& id, Course* target)
         target->addLesson(lesson);
     }
 
+    target->endBatch();
     target->setIsValid(true);
 
     return true;
@@ -346,6 +364,7 @@ bool UserDataAccess::loadKeyboardLayout(const QString& id, KeyboardLayout* targe
     target->setName(keyboardLayoutQuery.value(1).toString());
     target->setWidth(keyboardLayoutQuery.value(2).toInt());
     target->setHeight(keyboardLayoutQuery.value(3).toInt());
+    target->beginBatch();
     target->clearKeys();
 
     QSqlQuery keysQuery(db);
@@ -362,6 +381,7 @@ bool UserDataAccess::loadKeyboardLayout(const QString& id, KeyboardLayout* targe
     {
         qWarning() << keysQuery.lastError().text();
         raiseError(keysQuery.lastError());
+        target->endBatch();
         return false;
     }
 
@@ -385,6 +405,8 @@ bool UserDataAccess::loadKeyboardLayout(const QString& id, KeyboardLayout* targe
             {
                 qWarning() << keyCharsQuery.lastError().text();
                 raiseError(keyCharsQuery.lastError());
+                delete key;
+                target->endBatch();
                 return false;
             }
 
@@ -420,6 +442,7 @@ bool UserDataAccess::loadKeyboardLayout(const QString& id, KeyboardLayout* targe
         target->addKey(abstractKey);
     }
 
+    target->endBatch();
     target->setIsValid(true);
 
     return true;
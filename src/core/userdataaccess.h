@@ -20,6 +20,7 @@
 
 #include "core/dbaccess.h"
 
+class QThread;
 class DataIndex;
 class Course;
 class KeyboardLayout;
@@ -30,6 +31,12 @@ class UserDataAccess : public DbAccess
 public:
     explicit UserDataAccess(QObject* parent = 0);
     Q_INVOKABLE bool fillDataIndex(DataIndex* target);
+    /**
+     * Creates a data index of the resources in the user database. The
+     * index is moved to @p targetThread and is invalid if the database
+     * couldn't be read. Safe to call from worker threads.
+     */
+    static DataIndex* loadDataIndex(QThread* targetThread);
     Q_INVOKABLE bool loadCourse(const QString& id, Course* target);
     Q_INVOKABLE bool storeCourse(Course* course);
     Q_INVOKABLE bool deleteCourse(Course* course);
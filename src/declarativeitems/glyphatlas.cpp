@@ -0,0 +1,315 @@
+/*
+ *  Copyright 2026  Sebastian Gottfried <sebastian.gottfried@posteo.de>
+ *
+ *  This program is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU General Public License as
+ *  published by the Free Software Foundation; either version 2 of
+ *  the License, or (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "glyphatlas.h"
+
+#include <QGlyphRun>
+#include <QOpenGLShaderProgram>
+#include <QPainter>
+#include <QQuickWindow>
+#include <QSGTexture>
+
+namespace
+{
+    const int atlasSize = 512;
+    const int solidBlockSize = 4;
+
+    quint64 glyphKey(int fontIndex, quint32 glyphIndex)
+    {
+        return (quint64(fontIndex) << 32) | glyphIndex;
+    }
+
+    class GlyphMaterialShader : public QSGMaterialShader
+    {
+    public:
+        GlyphMaterialShader():
+            m_matrixId(-1),
+            m_opacityId(-1)
+        {
+        }
+
+        void updateState(const RenderState& state, QSGMaterial* newMaterial, QSGMaterial* oldMaterial) override
+        {
+            Q_UNUSED(oldMaterial)
+
+            if (state.isMatrixDirty())
+            {
+                program()->setUniformValue(m_matrixId, state.combinedMatrix());
+            }
+
+            if (state.isOpacityDirty())
+            {
+                program()->setUniformValue(m_opacityId, state.opacity());
+            }
+
+            if (QSGTexture* texture = static_cast<GlyphMaterial*>(newMaterial)->texture())
+            {
+                texture->bind();
+            }
+        }
+
+        char const* const* attributeNames() const override
+        {
+            static const char* const names[] = {"vertex", "textureCoord", "vertexColor", 0};
+            return names;
+        }
+
+    protected:
+        void initialize() override
+        {
+            m_matrixId = program()->uniformLocation("matrix");
+            m_opacityId = program()->uniformLocation("opacity");
+        }
+
+        const char* vertexShader() const override
+        {
+            return
+                "attribute highp vec4 vertex;\n"
+                "attribute highp vec2 textureCoord;\n"
+                "attribute lowp vec4 vertexColor;\n"
+                "uniform highp mat4 matrix;\n"
+                "uniform lowp float opacity;\n"
+                "varying highp vec2 glyphPos;\n"
+                "varying lowp vec4 color;\n"
+                "void main() {\n"
+                "    glyphPos = textureCoord;\n"
+                "    color = vertexColor * opacity;\n"
+                "    gl_Position = matrix * vertex;\n"
+                "}\n";
+        }
+
+        const char* fragmentShader() const override
+        {
+            return
+                "uniform sampler2D glyphs;\n"
+                "varying highp vec2 glyphPos;\n"
+                "varying lowp vec4 color;\n"
+                "void main() {\n"
+                "    gl_FragColor = color * texture2D(glyphs, glyphPos).a;\n"
+                "}\n";
+        }
+
+    private:
+        int m_matrixId;
+        int m_opacityId;
+    };
+}
+
+GlyphAtlas::GlyphAtlas():
+    m_shelfHeight(0),
+    m_dirty(true)
+{
+}
+
+int GlyphAtlas::fontIndex(const QRawFont& rawFont)
+{
+    int index = m_rawFonts.indexOf(rawFont);
+
+    if (index == -1)
+    {
+        index = m_rawFonts.length();
+        m_rawFonts.append(rawFont);
+    }
+
+    return index;
+}
+
+/**
+ * Rasterizes the glyph if it isn't in the atlas yet. Returns true if the
+ * atlas had to grow, all texture coordinates have to be updated then.
+ */
+bool GlyphAtlas::addGlyph(int fontIndex, quint32 glyphIndex)
+{
+    const quint64 key = glyphKey(fontIndex, glyphIndex);
+
+    if (m_glyphs.contains(key))
+        return false;
+
+    const QRawFont& rawFont = m_rawFonts.at(fontIndex);
+    const QRectF boundingRect = rawFont.boundingRect(glyphIndex);
+    Glyph glyph;
+
+    if (boundingRect.isEmpty())
+    {
+        m_glyphs.insert(key, glyph);
+        return false;
+    }
+
+    // leave some room for antialiasing
+    const QRect glyphRect = boundingRect.toAlignedRect().adjusted(-1, -1, 1, 1);
+    bool grown = false;
+
+    ensureImage();
+
+    if (m_cursor.x() + glyphRect.width() > m_image.width())
+    {
+        m_cursor = QPoint(0, m_cursor.y() + m_shelfHeight);
+        m_shelfHeight = 0;
+    }
+
+    if (m_cursor.y() + glyphRect.height() > m_image.height() || glyphRect.width() > m_image.width())
+    {
+        int height = m_image.height();
+
+        while (m_cursor.y() + glyphRect.height() > height)
+        {
+            height *= 2;
+        }
+
+        QImage image(qMax(m_image.width(), glyphRect.width()), height, QImage::Format_ARGB32_Premultiplied);
+        image.fill(Qt::transparent);
+        QPainter painter(&image);
+        painter.setCompositionMode(QPainter::CompositionMode_Source);
+        painter.drawImage(0, 0, m_image);
+        painter.end();
+        m_image = image;
+        grown = true;
+    }
+
+    glyph.rect = QRect(m_cursor, glyphRect.size());
+    glyph.offset = glyphRect.topLeft();
+
+    QGlyphRun glyphRun;
+    glyphRun.setRawFont(rawFont);
+    glyphRun.setGlyphIndexes(QVector<quint32>() << glyphIndex);
+    glyphRun.setPositions(QVector<QPointF>() << QPointF(0, 0));
+
+    QPainter painter(&m_image);
+    painter.setPen(Qt::white);
+    painter.drawGlyphRun(QPointF(glyph.rect.topLeft() - glyphRect.topLeft()), glyphRun);
+    painter.end();
+
+    m_cursor.rx() += glyphRect.width();
+    m_shelfHeight = qMax(m_shelfHeight, glyphRect.height());
+    m_glyphs.insert(key, glyph);
+    m_dirty = true;
+
+    return grown;
+}
+
+GlyphAtlas::Glyph GlyphAtlas::glyph(int fontIndex, quint32 glyphIndex) const
+{
+    return m_glyphs.value(glyphKey(fontIndex, glyphIndex));
+}
+
+QRectF GlyphAtlas::textureRect(const QRect& rect) const
+{
+    const qreal width = m_image.width();
+    const qreal height = m_image.height();
+    return QRectF(rect.x() / width, rect.y() / height, rect.width() / width, rect.height() / height);
+}
+
+/**
+ * Texture coordinate inside the opaque block, for drawing solid shapes.
+ */
+QPointF GlyphAtlas::solidTexturePosition()
+{
+    ensureImage();
+    return QPointF(0.5 * solidBlockSize / m_image.width(), 0.5 * solidBlockSize / m_image.height());
+}
+
+const QImage& GlyphAtlas::image() const
+{
+    return m_image;
+}
+
+bool GlyphAtlas::isDirty() const
+{
+    return m_dirty;
+}
+
+QSGTexture* GlyphAtlas::createTexture(QQuickWindow* window)
+{
+    m_dirty = false;
+    return m_image.isNull()? 0: window->createTextureFromImage(m_image);
+}
+
+void GlyphAtlas::clear()
+{
+    m_rawFonts.clear();
+    m_glyphs.clear();
+    m_image = QImage();
+    m_cursor = QPoint();
+    m_shelfHeight = 0;
+    m_dirty = true;
+}
+
+void GlyphAtlas::ensureImage()
+{
+    if (!m_image.isNull())
+        return;
+
+    m_image = QImage(atlasSize, atlasSize, QImage::Format_ARGB32_Premultiplied);
+    m_image.fill(Qt::transparent);
+
+    // the first shelf starts with the opaque block
+    QPainter painter(&m_image);
+    painter.fillRect(0, 0, solidBlockSize, solidBlockSize, Qt::white);
+    painter.end();
+
+    m_cursor = QPoint(solidBlockSize, 0);
+    m_shelfHeight = solidBlockSize;
+    m_dirty = true;
+}
+
+const QSGGeometry::AttributeSet& glyphAttributes()
+{
+    static const QSGGeometry::Attribute attributes[] = {
+        QSGGeometry::Attribute::createWithAttributeType(0, 2, QSGGeometry::FloatType, QSGGeometry::PositionAttribute),
+        QSGGeometry::Attribute::createWithAttributeType(1, 2, QSGGeometry::FloatType, QSGGeometry::TexCoordAttribute),
+        QSGGeometry::Attribute::createWithAttributeType(2, 4, QSGGeometry::UnsignedByteType, QSGGeometry::ColorAttribute)
+    };
+    static const QSGGeometry::AttributeSet attributeSet = {3, sizeof(GlyphVertex), attributes};
+    return attributeSet;
+}
+
+GlyphMaterial::GlyphMaterial():
+    m_texture(0)
+{
+    setFlag(Blending);
+}
+
+QSGMaterialType* GlyphMaterial::type() const
+{
+    static QSGMaterialType type;
+    return &type;
+}
+
+QSGMaterialShader* GlyphMaterial::createShader() const
+{
+    return new GlyphMaterialShader();
+}
+
+int GlyphMaterial::compare(const QSGMaterial* other) const
+{
+    const QSGTexture* otherTexture = static_cast<const GlyphMaterial*>(other)->m_texture;
+
+    if (m_texture == otherTexture)
+        return 0;
+
+    return m_texture < otherTexture? -1: 1;
+}
+
+QSGTexture* GlyphMaterial::texture() const
+{
+    return m_texture;
+}
+
+void GlyphMaterial::setTexture(QSGTexture* texture)
+{
+    m_texture = texture;
+}
@@ -0,0 +1,112 @@
+/*
+ *  Copyright 2026  Sebastian Gottfried <sebastian.gottfried@posteo.de>
+ *
+ *  This program is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU General Public License as
+ *  published by the Free Software Foundation; either version 2 of
+ *  the License, or (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef GLYPHATLAS_H
+#define GLYPHATLAS_H
+
+#include <QHash>
+#include <QImage>
+#include <QRawFont>
+#include <QSGGeometry>
+#include <QSGMaterial>
+#include <QVector>
+
+class QQuickWindow;
+class QSGTexture;
+
+/**
+ * Texture atlas of white glyphs for the scene graph based renderers.
+ *
+ * Glyphs are rasterized once at their device pixel size and packed in
+ * shelves. The atlas grows when it runs out of space, which invalidates all
+ * texture coordinates handed out before. A small opaque block in the corner
+ * can be used to draw solid shapes with the same material.
+ */
+class GlyphAtlas
+{
+public:
+    struct Glyph
+    {
+        // empty for glyphs without any pixels, like spaces
+        QRect rect;
+        QPoint offset;
+    };
+
+    GlyphAtlas();
+    int fontIndex(const QRawFont& rawFont);
+    bool addGlyph(int fontIndex, quint32 glyphIndex);
+    Glyph glyph(int fontIndex, quint32 glyphIndex) const;
+    QRectF textureRect(const QRect& rect) const;
+    QPointF solidTexturePosition();
+    const QImage& image() const;
+    bool isDirty() const;
+    QSGTexture* createTexture(QQuickWindow* window);
+    void clear();
+private:
+    void ensureImage();
+    QVector<QRawFont> m_rawFonts;
+    QHash<quint64, Glyph> m_glyphs;
+    QImage m_image;
+    QPoint m_cursor;
+    int m_shelfHeight;
+    bool m_dirty;
+};
+
+struct GlyphVertex
+{
+    void set(const QPointF& pos, const QPointF& texturePos, QRgb color)
+    {
+        x = pos.x();
+        y = pos.y();
+        tx = texturePos.x();
+        ty = texturePos.y();
+        r = qRed(color);
+        g = qGreen(color);
+        b = qBlue(color);
+        a = qAlpha(color);
+    }
+
+    float x;
+    float y;
+    float tx;
+    float ty;
+    unsigned char r;
+    unsigned char g;
+    unsigned char b;
+    unsigned char a;
+};
+
+const QSGGeometry::AttributeSet& glyphAttributes();
+
+/**
+ * Draws the coverage of the glyph atlas with the premultiplied vertex color.
+ * Doesn't own the texture.
+ */
+class GlyphMaterial : public QSGMaterial
+{
+public:
+    GlyphMaterial();
+    QSGMaterialType* type() const override;
+    QSGMaterialShader* createShader() const override;
+    int compare(const QSGMaterial* other) const override;
+    QSGTexture* texture() const;
+    void setTexture(QSGTexture* texture);
+private:
+    QSGTexture* m_texture;
+};
+
+#endif // GLYPHATLAS_H
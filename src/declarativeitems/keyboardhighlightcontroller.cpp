@@ -0,0 +1,215 @@
+/*
+ *  Copyright 2026  Sebastian Gottfried <sebastian.gottfried@posteo.de>
+ *
+ *  This program is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU General Public License as
+ *  published by the Free Software Foundation; either version 2 of
+ *  the License, or (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "keyboardhighlightcontroller.h"
+
+#include <QHash>
+
+#include "core/keyboardlayout.h"
+#include "declarativeitems/traininglinecore.h"
+#include "preferencescache.h"
+
+KeyboardHighlightController::KeyboardHighlightController(QObject* parent) :
+    QObject(parent),
+    m_keyboardLayout(0),
+    m_trainingLineCore(0),
+    m_enabled(true)
+{
+    connect(PreferencesCache::instance(), &PreferencesCache::snapshotChanged, this, &KeyboardHighlightController::updateHighlight);
+}
+
+KeyboardLayout* KeyboardHighlightController::keyboardLayout() const
+{
+    return m_keyboardLayout;
+}
+
+void KeyboardHighlightController::setKeyboardLayout(KeyboardLayout* keyboardLayout)
+{
+    if (keyboardLayout != m_keyboardLayout)
+    {
+        if (m_keyboardLayout)
+        {
+            m_keyboardLayout->disconnect(this);
+        }
+
+        m_keyboardLayout = keyboardLayout;
+
+        if (m_keyboardLayout)
+        {
+            connect(m_keyboardLayout, &KeyboardLayout::keyCountChanged, this, &KeyboardHighlightController::updateTargets);
+            connect(m_keyboardLayout, &KeyboardLayout::isValidChanged, this, &KeyboardHighlightController::updateTargets);
+        }
+
+        updateTargets();
+        emit keyboardLayoutChanged();
+    }
+}
+
+TrainingLineCore* KeyboardHighlightController::trainingLineCore() const
+{
+    return m_trainingLineCore;
+}
+
+void KeyboardHighlightController::setTrainingLineCore(TrainingLineCore* trainingLineCore)
+{
+    if (trainingLineCore != m_trainingLineCore)
+    {
+        if (m_trainingLineCore)
+        {
+            m_trainingLineCore->disconnect(this);
+        }
+
+        m_trainingLineCore = trainingLineCore;
+
+        if (m_trainingLineCore)
+        {
+            connect(m_trainingLineCore, &TrainingLineCore::referenceLineChanged, this, &KeyboardHighlightController::updateTargets);
+            connect(m_trainingLineCore, &TrainingLineCore::actualLineChanged, this, &KeyboardHighlightController::updateHighlight);
+        }
+
+        updateTargets();
+        emit trainingLineCoreChanged();
+    }
+}
+
+bool KeyboardHighlightController::enabled() const
+{
+    return m_enabled;
+}
+
+void KeyboardHighlightController::setEnabled(bool enabled)
+{
+    if (enabled != m_enabled)
+    {
+        m_enabled = enabled;
+        updateHighlight();
+        emit enabledChanged();
+    }
+}
+
+QList<int> KeyboardHighlightController::highlightedKeys() const
+{
+    return m_highlightedKeys.toList();
+}
+
+void KeyboardHighlightController::updateTargets()
+{
+    m_lineTargets.clear();
+
+    if (m_keyboardLayout && m_keyboardLayout->isValid() && m_trainingLineCore)
+    {
+        const QString referenceLine = m_trainingLineCore->referenceLine();
+        QHash<QChar, QVector<int> > characterTargets;
+
+        m_lineTargets.reserve(referenceLine.length());
+
+        foreach (QChar character, referenceLine)
+        {
+            auto it = characterTargets.find(character);
+
+            if (it == characterTargets.end())
+            {
+                it = characterTargets.insert(character, keysForCharacter(character));
+            }
+
+            m_lineTargets.append(it.value());
+        }
+    }
+
+    updateHighlight();
+}
+
+void KeyboardHighlightController::updateHighlight()
+{
+    if (!m_enabled || !m_keyboardLayout || !m_keyboardLayout->isValid() || !m_trainingLineCore)
+    {
+        setHighlightedKeys(QVector<int>());
+        return;
+    }
+
+    if (!m_trainingLineCore->isCorrect())
+    {
+        setHighlightedKeys(keysForKeyCode(Qt::Key_Backspace));
+        return;
+    }
+
+    const int position = m_trainingLineCore->actualLine().length();
+
+    if (position < m_lineTargets.count())
+    {
+        setHighlightedKeys(m_lineTargets.at(position));
+    }
+    else
+    {
+        setHighlightedKeys(keysForKeyCode(PreferencesCache::snapshot().nextLineWithSpace? Qt::Key_Space: Qt::Key_Return));
+    }
+}
+
+QVector<int> KeyboardHighlightController::keysForCharacter(QChar character) const
+{
+    const QString text(character);
+    QVector<int> keys;
+
+    foreach (int keyIndex, m_keyboardLayout->findKeyIndexes(text, -1))
+    {
+        keys.append(keyIndex);
+
+        const QString modifierId = m_keyboardLayout->modifierIdForCharacter(text, keyIndex);
+
+        if (!modifierId.isEmpty())
+        {
+            const int modifierKeyIndex = m_keyboardLayout->modifierKeyIndex(modifierId);
+
+            if (modifierKeyIndex != -1 && !keys.contains(modifierKeyIndex))
+            {
+                keys.append(modifierKeyIndex);
+            }
+        }
+    }
+
+    return keys;
+}
+
+QVector<int> KeyboardHighlightController::keysForKeyCode(int keyCode) const
+{
+    return m_keyboardLayout->findKeyIndexes(QString(), keyCode).toVector();
+}
+
+void KeyboardHighlightController::setHighlightedKeys(const QVector<int>& keys)
+{
+    if (keys == m_highlightedKeys)
+        return;
+
+    const QVector<int> previousKeys = m_highlightedKeys;
+    m_highlightedKeys = keys;
+
+    foreach (int keyIndex, previousKeys)
+    {
+        if (!keys.contains(keyIndex))
+        {
+            emit keyHighlightChanged(keyIndex, false);
+        }
+    }
+
+    foreach (int keyIndex, keys)
+    {
+        if (!previousKeys.contains(keyIndex))
+        {
+            emit keyHighlightChanged(keyIndex, true);
+        }
+    }
+}
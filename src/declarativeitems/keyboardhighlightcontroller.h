@@ -0,0 +1,71 @@
+/*
+ *  Copyright 2026  Sebastian Gottfried <sebastian.gottfried@posteo.de>
+ *
+ *  This program is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU General Public License as
+ *  published by the Free Software Foundation; either version 2 of
+ *  the License, or (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef KEYBOARDHIGHLIGHTCONTROLLER_H
+#define KEYBOARDHIGHLIGHTCONTROLLER_H
+
+#include <QObject>
+
+#include <QList>
+#include <QVector>
+
+class KeyboardLayout;
+class TrainingLineCore;
+
+/**
+ * Decides which keys of the keyboard have to be highlighted while training.
+ *
+ * The keys (and the modifier key) for every character of the reference line
+ * are looked up once when the line changes. After that the controller only
+ * picks the targets for the current position and emits keyHighlightChanged()
+ * for the keys whose state actually flips.
+ */
+class KeyboardHighlightController : public QObject
+{
+    Q_OBJECT
+    Q_PROPERTY(KeyboardLayout* keyboardLayout READ keyboardLayout WRITE setKeyboardLayout NOTIFY keyboardLayoutChanged)
+    Q_PROPERTY(TrainingLineCore* trainingLineCore READ trainingLineCore WRITE setTrainingLineCore NOTIFY trainingLineCoreChanged)
+    Q_PROPERTY(bool enabled READ enabled WRITE setEnabled NOTIFY enabledChanged)
+public:
+    explicit KeyboardHighlightController(QObject* parent = 0);
+    KeyboardLayout* keyboardLayout() const;
+    void setKeyboardLayout(KeyboardLayout* keyboardLayout);
+    TrainingLineCore* trainingLineCore() const;
+    void setTrainingLineCore(TrainingLineCore* trainingLineCore);
+    bool enabled() const;
+    void setEnabled(bool enabled);
+    Q_INVOKABLE QList<int> highlightedKeys() const;
+signals:
+    void keyboardLayoutChanged();
+    void trainingLineCoreChanged();
+    void enabledChanged();
+    void keyHighlightChanged(int keyIndex, bool highlighted);
+private slots:
+    void updateTargets();
+    void updateHighlight();
+private:
+    QVector<int> keysForCharacter(QChar character) const;
+    QVector<int> keysForKeyCode(int keyCode) const;
+    void setHighlightedKeys(const QVector<int>& keys);
+    KeyboardLayout* m_keyboardLayout;
+    TrainingLineCore* m_trainingLineCore;
+    bool m_enabled;
+    QVector<QVector<int> > m_lineTargets;
+    QVector<int> m_highlightedKeys;
+};
+
+#endif // KEYBOARDHIGHLIGHTCONTROLLER_H
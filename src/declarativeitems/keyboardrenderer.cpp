@@ -0,0 +1,706 @@
+/*
+ *  Copyright 2026  Sebastian Gottfried <sebastian.gottfried@posteo.de>
+ *
+ *  This program is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU General Public License as
+ *  published by the Free Software Foundation; either version 2 of
+ *  the License, or (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "keyboardrenderer.h"
+
+#include <QGlyphRun>
+#include <QGuiApplication>
+#include <QHash>
+#include <QQuickWindow>
+#include <QSGGeometryNode>
+#include <QSGTexture>
+#include <QTextLayout>
+#include <QTimer>
+#include <QVector>
+
+#include "core/key.h"
+#include "core/keychar.h"
+#include "core/keyboardlayout.h"
+#include "core/specialkey.h"
+#include "declarativeitems/glyphatlas.h"
+#include "declarativeitems/keyboardhighlightcontroller.h"
+#include "declarativeitems/lessonkeymask.h"
+#include "preferencescache.h"
+
+struct KeyboardRendererGlyph
+{
+    int fontIndex;
+    quint32 glyphIndex;
+    // origin of the glyph on the baseline, in device pixels
+    QPointF position;
+};
+
+struct KeyboardRendererLabel
+{
+    // relative to the top left corner of the label
+    QVector<KeyboardRendererGlyph> glyphs;
+    QSizeF size;
+};
+
+struct KeyboardRendererKey
+{
+    KeyboardRendererKey():
+        tint(Qt::transparent),
+        hasHapticMarker(false),
+        enabled(true),
+        pressed(false),
+        highlighted(false),
+        firstQuad(0),
+        quadCount(0),
+        dirty(true)
+    {
+    }
+
+    QRectF rect;
+    QColor tint;
+    bool hasHapticMarker;
+    bool enabled;
+    bool pressed;
+    bool highlighted;
+    QVector<KeyboardRendererGlyph> glyphs;
+    int firstQuad;
+    int quadCount;
+    bool dirty;
+};
+
+namespace
+{
+    // the geometry uses 16 bit indices
+    const int maxQuads = 0xffff / 4;
+    // highlight, border and the upper and lower half of the body
+    const int fixedQuadsPerKey = 4;
+    const int pulseExpandedDuration = 850;
+    const int pulseCollapsedDuration = 150;
+    const qreal highlightMargin = 2;
+
+    // the gradient stops of the key body, like in KeyItem.qml
+    const QRgb normalColors[] = {0xfff0f0f0, 0xffd5d5d5, 0xffcccccc};
+    const QRgb pressedColors[] = {0xff666666, 0xff888888, 0xff999999};
+    const QRgb disabledColors[] = {0xff444444, 0xff333333, 0xff222222};
+    const QRgb labelColor = 0xff222222;
+    const QRgb borderColor = 0xff000000;
+    const QRgb highlightColor = 0xff54a7f0;
+
+    QRgb tinted(QRgb base, const QColor& tint)
+    {
+        // same as Qt.tint() for opaque base colors
+        const qreal alpha = tint.alphaF();
+        return qRgb(
+                    qRound(qRed(base) * (1 - alpha) + tint.red() * alpha),
+                    qRound(qGreen(base) * (1 - alpha) + tint.green() * alpha),
+                    qRound(qBlue(base) * (1 - alpha) + tint.blue() * alpha));
+    }
+
+    QString specialKeyLabel(SpecialKey* key)
+    {
+        switch (key->type())
+        {
+        case SpecialKey::Other:
+            return key->label();
+        case SpecialKey::Tab:
+            return QStringLiteral("↹");
+        case SpecialKey::Capslock:
+            return QStringLiteral("⇩");
+        case SpecialKey::Shift:
+            return QStringLiteral("⇧");
+        case SpecialKey::Backspace:
+            return QStringLiteral("←");
+        case SpecialKey::Return:
+            return QStringLiteral("↵");
+        default:
+            return QString();
+        }
+    }
+
+    QString keyCharLabel(Key* key, KeyChar::Position position)
+    {
+        foreach (KeyChar* keyChar, key->keyChars())
+        {
+            if (keyChar->position() == position)
+                return QString(keyChar->value());
+        }
+
+        return QString();
+    }
+
+    void setQuad(GlyphVertex* vertices, const QRectF& rect, const QRectF& textureRect, QRgb topColor, QRgb bottomColor)
+    {
+        vertices[0].set(rect.topLeft(), textureRect.topLeft(), topColor);
+        vertices[1].set(rect.topRight(), textureRect.topRight(), topColor);
+        vertices[2].set(rect.bottomLeft(), textureRect.bottomLeft(), bottomColor);
+        vertices[3].set(rect.bottomRight(), textureRect.bottomRight(), bottomColor);
+    }
+
+    class KeyboardNode : public QSGGeometryNode
+    {
+    public:
+        KeyboardNode():
+            atlasTexture(0)
+        {
+            QSGGeometry* geometry = new QSGGeometry(glyphAttributes(), 0, 0, QSGGeometry::UnsignedShortType);
+            geometry->setDrawingMode(QSGGeometry::DrawTriangles);
+            setGeometry(geometry);
+            setFlag(QSGNode::OwnsGeometry);
+            setMaterial(&glyphMaterial);
+        }
+
+        ~KeyboardNode()
+        {
+            delete atlasTexture;
+        }
+
+        void setAtlasTexture(QSGTexture* texture)
+        {
+            delete atlasTexture;
+            atlasTexture = texture;
+            glyphMaterial.setTexture(texture);
+            markDirty(QSGNode::DirtyMaterial);
+        }
+
+        GlyphMaterial glyphMaterial;
+        QSGTexture* atlasTexture;
+    };
+}
+
+struct KeyboardRendererPrivate
+{
+    KeyboardRendererPrivate():
+        devicePixelRatio(1.0),
+        pulseTimer(0),
+        pulseExpanded(true),
+        structureDirty(true),
+        atlasDirty(true),
+        keysDirty(false)
+    {
+    }
+
+    KeyboardRendererLabel layoutLabel(const QString& text, const QFont& font)
+    {
+        KeyboardRendererLabel label;
+
+        QTextLayout layout(text, font);
+        layout.beginLayout();
+        QTextLine line = layout.createLine();
+        line.setNumColumns(text.length());
+        line.setPosition(QPointF(0, 0));
+        layout.endLayout();
+
+        label.size = QSizeF(line.naturalTextWidth(), line.height());
+
+        foreach (const QGlyphRun& glyphRun, layout.glyphRuns())
+        {
+            const int fontIndex = atlas.fontIndex(glyphRun.rawFont());
+            const QVector<quint32> glyphIndexes = glyphRun.glyphIndexes();
+            const QVector<QPointF> positions = glyphRun.positions();
+
+            for (int i = 0; i < glyphIndexes.length(); i++)
+            {
+                atlas.addGlyph(fontIndex, glyphIndexes.at(i));
+                const KeyboardRendererGlyph glyph = {fontIndex, glyphIndexes.at(i), positions.at(i)};
+                label.glyphs.append(glyph);
+            }
+        }
+
+        return label;
+    }
+
+    void addLabel(KeyboardRendererKey& key, const QString& text, KeyChar::Position position, const QRectF& deviceArea, const QFont& font)
+    {
+        if (text.isEmpty())
+            return;
+
+        auto it = labels.constFind(text);
+
+        if (it == labels.constEnd())
+        {
+            it = labels.insert(text, layoutLabel(text, font));
+        }
+
+        const KeyboardRendererLabel& label = it.value();
+        const bool right = position == KeyChar::TopRight || position == KeyChar::BottomRight;
+        const bool bottom = position == KeyChar::BottomLeft || position == KeyChar::BottomRight;
+        const QPointF offset(
+                    right? deviceArea.right() - label.size.width(): deviceArea.left(),
+                    bottom? deviceArea.bottom() - label.size.height(): deviceArea.top());
+
+        foreach (KeyboardRendererGlyph glyph, label.glyphs)
+        {
+            glyph.position += offset;
+            key.glyphs.append(glyph);
+        }
+    }
+
+    int keyQuadCount(const KeyboardRendererKey& key) const
+    {
+        int count = fixedQuadsPerKey;
+
+        if (key.hasHapticMarker)
+        {
+            count++;
+        }
+
+        foreach (const KeyboardRendererGlyph& glyph, key.glyphs)
+        {
+            if (!atlas.glyph(glyph.fontIndex, glyph.glyphIndex).rect.isEmpty())
+            {
+                count++;
+            }
+        }
+
+        return count;
+    }
+
+    void writeKey(GlyphVertex* vertices, const KeyboardRendererKey& key) const
+    {
+        const QRectF solid(solidTexturePosition, QSizeF(0, 0));
+        const QRgb* colors = !key.enabled? disabledColors: key.pressed? pressedColors: normalColors;
+        const QRgb topColor = tinted(colors[0], key.tint);
+        const QRgb middleColor = tinted(colors[1], key.tint);
+        const QRgb bottomColor = tinted(colors[2], key.tint);
+
+        const qreal margin = key.highlighted && pulseExpanded? highlightMargin: 0;
+        const QRgb keyHighlightColor = key.highlighted? highlightColor: qRgba(0, 0, 0, 0);
+        setQuad(vertices, key.rect.adjusted(-margin, -margin, margin, margin), solid, keyHighlightColor, keyHighlightColor);
+        vertices += 4;
+
+        setQuad(vertices, key.rect, solid, borderColor, borderColor);
+        vertices += 4;
+
+        const QRectF body = key.rect.adjusted(1, 1, -1, -1);
+        const qreal middle = body.top() + body.height() / 2;
+        setQuad(vertices, QRectF(QPointF(body.left(), body.top()), QPointF(body.right(), middle)), solid, topColor, middleColor);
+        vertices += 4;
+        setQuad(vertices, QRectF(QPointF(body.left(), middle), QPointF(body.right(), body.bottom())), solid, middleColor, bottomColor);
+        vertices += 4;
+
+        if (key.hasHapticMarker)
+        {
+            const QRectF marker(key.rect.center().x() - key.rect.width() / 6, key.rect.bottom() - 4 - 3, key.rect.width() / 3, 3);
+            setQuad(vertices, marker, solid, labelColor, labelColor);
+            vertices += 4;
+        }
+
+        foreach (const KeyboardRendererGlyph& glyph, key.glyphs)
+        {
+            const GlyphAtlas::Glyph atlasGlyph = atlas.glyph(glyph.fontIndex, glyph.glyphIndex);
+
+            if (atlasGlyph.rect.isEmpty())
+                continue;
+
+            // glyphs are rasterized at integer positions, so snap them to the pixel grid
+            const QPoint devicePos = QPoint(qRound(glyph.position.x()), qRound(glyph.position.y())) + atlasGlyph.offset;
+            const QRectF rect(QPointF(devicePos) / devicePixelRatio, QSizeF(atlasGlyph.rect.size()) / devicePixelRatio);
+            setQuad(vertices, rect, atlas.textureRect(atlasGlyph.rect), labelColor, labelColor);
+            vertices += 4;
+        }
+    }
+
+    QVector<KeyboardRendererKey> keys;
+    QHash<QString, KeyboardRendererLabel> labels;
+    GlyphAtlas atlas;
+    QPointF solidTexturePosition;
+    qreal devicePixelRatio;
+    QTimer* pulseTimer;
+    bool pulseExpanded;
+    bool structureDirty;
+    bool atlasDirty;
+    bool keysDirty;
+};
+
+KeyboardRenderer::KeyboardRenderer(QQuickItem* parent) :
+    QQuickItem(parent),
+    d(new KeyboardRendererPrivate())
+{
+    setFlag(QQuickItem::ItemHasContents, true);
+
+    d->pulseTimer = new QTimer(this);
+    d->pulseTimer->setSingleShot(true);
+    connect(d->pulseTimer, &QTimer::timeout, this, &KeyboardRenderer::pulse);
+
+    // the finger colors tint the keys
+    connect(PreferencesCache::instance(), &PreferencesCache::snapshotChanged, this, &KeyboardRenderer::updateLayout);
+}
+
+KeyboardRenderer::~KeyboardRenderer()
+{
+    delete d;
+}
+
+KeyboardLayout* KeyboardRenderer::keyboardLayout() const
+{
+    return m_keyboardLayout;
+}
+
+void KeyboardRenderer::setKeyboardLayout(KeyboardLayout* keyboardLayout)
+{
+    if (keyboardLayout != m_keyboardLayout)
+    {
+        if (m_keyboardLayout)
+        {
+            m_keyboardLayout->disconnect(this);
+        }
+
+        m_keyboardLayout = keyboardLayout;
+
+        if (m_keyboardLayout)
+        {
+            connect(m_keyboardLayout.data(), &KeyboardLayout::isValidChanged, this, &KeyboardRenderer::updateLayout);
+            connect(m_keyboardLayout.data(), &KeyboardLayout::keyCountChanged, this, &KeyboardRenderer::updateLayout);
+            connect(m_keyboardLayout.data(), &KeyboardLayout::widthChanged, this, &KeyboardRenderer::updateLayout);
+            connect(m_keyboardLayout.data(), &KeyboardLayout::heightChanged, this, &KeyboardRenderer::updateLayout);
+            connect(m_keyboardLayout.data(), &KeyboardLayout::referenceKeyChanged, this, &KeyboardRenderer::updateLayout);
+        }
+
+        updateLayout();
+        emit keyboardLayoutChanged();
+    }
+}
+
+LessonKeyMask* KeyboardRenderer::keyMask() const
+{
+    return m_keyMask;
+}
+
+void KeyboardRenderer::setKeyMask(LessonKeyMask* keyMask)
+{
+    if (keyMask != m_keyMask)
+    {
+        if (m_keyMask)
+        {
+            m_keyMask->disconnect(this);
+        }
+
+        m_keyMask = keyMask;
+
+        if (m_keyMask)
+        {
+            connect(m_keyMask.data(), &LessonKeyMask::enabledKeysChanged, this, &KeyboardRenderer::updateEnabledKeys);
+        }
+
+        updateEnabledKeys();
+        emit keyMaskChanged();
+    }
+}
+
+KeyboardHighlightController* KeyboardRenderer::highlightController() const
+{
+    return m_highlightController;
+}
+
+void KeyboardRenderer::setHighlightController(KeyboardHighlightController* highlightController)
+{
+    if (highlightController != m_highlightController)
+    {
+        if (m_highlightController)
+        {
+            m_highlightController->disconnect(this);
+        }
+
+        m_highlightController = highlightController;
+
+        if (m_highlightController)
+        {
+            connect(m_highlightController.data(), &KeyboardHighlightController::keyHighlightChanged, this, &KeyboardRenderer::setKeyHighlighted);
+        }
+
+        updateHighlightedKeys();
+        emit highlightControllerChanged();
+    }
+}
+
+void KeyboardRenderer::setKeyPressed(int keyIndex, bool pressed)
+{
+    if (keyIndex < 0 || keyIndex >= d->keys.length() || d->keys.at(keyIndex).pressed == pressed)
+        return;
+
+    d->keys[keyIndex].pressed = pressed;
+    markKeyDirty(keyIndex);
+}
+
+QSGNode* KeyboardRenderer::updatePaintNode(QSGNode* oldNode, UpdatePaintNodeData* data)
+{
+    Q_UNUSED(data)
+
+    KeyboardNode* node = static_cast<KeyboardNode*>(oldNode);
+
+    if (d->keys.isEmpty())
+    {
+        delete node;
+        return 0;
+    }
+
+    if (!node)
+    {
+        node = new KeyboardNode();
+        d->atlasDirty = true;
+        d->structureDirty = true;
+    }
+
+    if (d->atlasDirty || d->atlas.isDirty())
+    {
+        node->setAtlasTexture(d->atlas.createTexture(window()));
+        d->atlasDirty = false;
+    }
+
+    QSGGeometry* geometry = node->geometry();
+
+    if (d->structureDirty)
+    {
+        int quadCount = 0;
+
+        for (int i = 0; i < d->keys.length(); i++)
+        {
+            KeyboardRendererKey& key = d->keys[i];
+            const int keyQuadCount = d->keyQuadCount(key);
+
+            key.firstQuad = quadCount;
+            key.quadCount = quadCount + keyQuadCount <= maxQuads? keyQuadCount: 0;
+            key.dirty = true;
+            quadCount += key.quadCount;
+        }
+
+        geometry->allocate(quadCount * 4, quadCount * 6);
+        quint16* indices = geometry->indexDataAsUShort();
+
+        for (int quad = 0; quad < quadCount; quad++)
+        {
+            const quint16 first = quad * 4;
+            indices[0] = first;
+            indices[1] = first + 1;
+            indices[2] = first + 2;
+            indices[3] = first + 1;
+            indices[4] = first + 3;
+            indices[5] = first + 2;
+            indices += 6;
+        }
+
+        d->structureDirty = false;
+        d->keysDirty = true;
+    }
+
+    if (d->keysDirty)
+    {
+        GlyphVertex* vertices = static_cast<GlyphVertex*>(geometry->vertexData());
+
+        for (int i = 0; i < d->keys.length(); i++)
+        {
+            KeyboardRendererKey& key = d->keys[i];
+
+            if (key.dirty && key.quadCount > 0)
+            {
+                d->writeKey(vertices + key.firstQuad * 4, key);
+            }
+
+            key.dirty = false;
+        }
+
+        node->markDirty(QSGNode::DirtyGeometry);
+        d->keysDirty = false;
+    }
+
+    return node;
+}
+
+void KeyboardRenderer::geometryChanged(const QRectF& newGeometry, const QRectF& oldGeometry)
+{
+    QQuickItem::geometryChanged(newGeometry, oldGeometry);
+
+    if (newGeometry.size() != oldGeometry.size())
+    {
+        updateLayout();
+    }
+}
+
+void KeyboardRenderer::itemChange(ItemChange change, const ItemChangeData& value)
+{
+    if (change == ItemSceneChange || change == ItemDevicePixelRatioHasChanged)
+    {
+        updateLayout();
+    }
+    else if (change == ItemVisibleHasChanged)
+    {
+        updateHighlightedKeys();
+    }
+
+    QQuickItem::itemChange(change, value);
+}
+
+void KeyboardRenderer::updateLayout()
+{
+    d->keys.clear();
+    d->labels.clear();
+    d->atlas.clear();
+    d->structureDirty = true;
+
+    if (!m_keyboardLayout || !m_keyboardLayout->isValid() || m_keyboardLayout->width() <= 0 || m_keyboardLayout->height() <= 0 || width() <= 0 || height() <= 0)
+    {
+        update();
+        return;
+    }
+
+    d->devicePixelRatio = window()? window()->effectiveDevicePixelRatio(): 1.0;
+
+    const qreal devicePixelRatio = d->devicePixelRatio;
+    const qreal horizontalScaleFactor = width() / m_keyboardLayout->width();
+    const qreal verticalScaleFactor = height() / m_keyboardLayout->height();
+    AbstractKey* const referenceKey = m_keyboardLayout->referenceKey();
+    const qreal referenceWidth = referenceKey? referenceKey->width(): 0;
+    const qreal referenceHeight = referenceKey? referenceKey->height(): 0;
+
+    // same metrics as KeyItem.qml and KeyLabel.qml
+    const qreal horizontalMargin = qMax(referenceWidth / 10, qreal(5)) * horizontalScaleFactor;
+    const qreal verticalMargin = qMax(referenceWidth / 20, qreal(3)) * verticalScaleFactor;
+    QFont font = QGuiApplication::font();
+    font.setPixelSize(qMax(1, qRound(referenceHeight * qMin(horizontalScaleFactor, verticalScaleFactor) / 3 * devicePixelRatio)));
+
+    const PreferencesSnapshot& preferences = PreferencesCache::snapshot();
+    const KeyChar::Position positions[] = {KeyChar::TopLeft, KeyChar::TopRight, KeyChar::BottomLeft, KeyChar::BottomRight};
+
+    d->keys.resize(m_keyboardLayout->keyCount());
+
+    for (int i = 0; i < d->keys.length(); i++)
+    {
+        AbstractKey* const abstractKey = m_keyboardLayout->key(i);
+        KeyboardRendererKey& key = d->keys[i];
+
+        key.rect = QRectF(
+                    qRound(abstractKey->left() * horizontalScaleFactor),
+                    qRound(abstractKey->top() * verticalScaleFactor),
+                    qRound(abstractKey->width() * horizontalScaleFactor),
+                    qRound(abstractKey->height() * verticalScaleFactor));
+
+        const QRectF labelArea = key.rect.adjusted(horizontalMargin, verticalMargin, -horizontalMargin, -verticalMargin);
+        const QRectF deviceLabelArea(labelArea.topLeft() * devicePixelRatio, labelArea.size() * devicePixelRatio);
+
+        if (Key* const normalKey = qobject_cast<Key*>(abstractKey))
+        {
+            const int fingerIndex = normalKey->fingerIndex();
+
+            if (fingerIndex >= 0 && fingerIndex < PreferencesSnapshot::fingerColorCount)
+            {
+                key.tint = preferences.fingerColors[fingerIndex];
+                key.tint.setAlphaF(0.125);
+            }
+
+            key.hasHapticMarker = normalKey->hasHapticMarker();
+
+            foreach (KeyChar::Position position, positions)
+            {
+                d->addLabel(key, keyCharLabel(normalKey, position), position, deviceLabelArea, font);
+            }
+        }
+        else if (SpecialKey* const specialKey = qobject_cast<SpecialKey*>(abstractKey))
+        {
+            d->addLabel(key, specialKeyLabel(specialKey), KeyChar::TopLeft, deviceLabelArea, font);
+        }
+    }
+
+    // after all glyphs are in, the position is relative to the final atlas size
+    d->solidTexturePosition = d->atlas.solidTexturePosition();
+
+    updateEnabledKeys();
+    updateHighlightedKeys();
+    update();
+}
+
+void KeyboardRenderer::updateEnabledKeys()
+{
+    const QList<bool> enabledKeys = m_keyMask? m_keyMask->enabledKeys(): QList<bool>();
+
+    for (int i = 0; i < d->keys.length(); i++)
+    {
+        const bool enabled = i < enabledKeys.length()? enabledKeys.at(i): true;
+
+        if (d->keys.at(i).enabled != enabled)
+        {
+            d->keys[i].enabled = enabled;
+            markKeyDirty(i);
+        }
+    }
+}
+
+void KeyboardRenderer::setKeyHighlighted(int keyIndex, bool highlighted)
+{
+    if (keyIndex < 0 || keyIndex >= d->keys.length() || d->keys.at(keyIndex).highlighted == highlighted)
+        return;
+
+    d->keys[keyIndex].highlighted = highlighted;
+    markKeyDirty(keyIndex);
+
+    // a new highlight starts with the pulse expanded, like the key items do
+    if (highlighted)
+    {
+        d->pulseExpanded = false;
+        d->pulseTimer->stop();
+    }
+
+    updateHighlightedKeys();
+}
+
+void KeyboardRenderer::pulse()
+{
+    d->pulseExpanded = !d->pulseExpanded;
+
+    for (int i = 0; i < d->keys.length(); i++)
+    {
+        if (d->keys.at(i).highlighted)
+        {
+            markKeyDirty(i);
+        }
+    }
+
+    d->pulseTimer->start(d->pulseExpanded? pulseExpandedDuration: pulseCollapsedDuration);
+}
+
+void KeyboardRenderer::updateHighlightedKeys()
+{
+    const QList<int> highlightedKeys = m_highlightController? m_highlightController->highlightedKeys(): QList<int>();
+    bool anyHighlighted = false;
+
+    for (int i = 0; i < d->keys.length(); i++)
+    {
+        const bool highlighted = highlightedKeys.contains(i);
+
+        if (d->keys.at(i).highlighted != highlighted)
+        {
+            d->keys[i].highlighted = highlighted;
+            markKeyDirty(i);
+        }
+
+        anyHighlighted = anyHighlighted || highlighted;
+    }
+
+    // the pulse only runs while there is something to see
+    if (anyHighlighted && isVisible())
+    {
+        if (!d->pulseTimer->isActive())
+        {
+            pulse();
+        }
+    }
+    else
+    {
+        d->pulseTimer->stop();
+    }
+}
+
+void KeyboardRenderer::markKeyDirty(int keyIndex)
+{
+    d->keys[keyIndex].dirty = true;
+    d->keysDirty = true;
+    update();
+}
@@ -0,0 +1,79 @@
+/*
+ *  Copyright 2026  Sebastian Gottfried <sebastian.gottfried@posteo.de>
+ *
+ *  This program is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU General Public License as
+ *  published by the Free Software Foundation; either version 2 of
+ *  the License, or (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef KEYBOARDRENDERER_H
+#define KEYBOARDRENDERER_H
+
+#include <QQuickItem>
+
+#include <QPointer>
+
+class KeyboardHighlightController;
+class KeyboardLayout;
+class LessonKeyMask;
+struct KeyboardRendererPrivate;
+
+/**
+ * Draws a whole keyboard layout as a single scene graph node.
+ *
+ * Key bodies, highlights and labels are quads in one geometry sharing the
+ * glyph atlas material, solid shapes use the opaque block of the atlas. The
+ * key states only change the vertices of the affected keys. This is the
+ * lightweight alternative to the KeyItem based keyboard, which is still used
+ * by the keyboard layout editor.
+ *
+ * Needs the OpenGL scene graph backend.
+ */
+class KeyboardRenderer : public QQuickItem
+{
+    Q_OBJECT
+    Q_PROPERTY(KeyboardLayout* keyboardLayout READ keyboardLayout WRITE setKeyboardLayout NOTIFY keyboardLayoutChanged)
+    Q_PROPERTY(LessonKeyMask* keyMask READ keyMask WRITE setKeyMask NOTIFY keyMaskChanged)
+    Q_PROPERTY(KeyboardHighlightController* highlightController READ highlightController WRITE setHighlightController NOTIFY highlightControllerChanged)
+public:
+    explicit KeyboardRenderer(QQuickItem* parent = 0);
+    ~KeyboardRenderer();
+    KeyboardLayout* keyboardLayout() const;
+    void setKeyboardLayout(KeyboardLayout* keyboardLayout);
+    LessonKeyMask* keyMask() const;
+    void setKeyMask(LessonKeyMask* keyMask);
+    KeyboardHighlightController* highlightController() const;
+    void setHighlightController(KeyboardHighlightController* highlightController);
+    Q_INVOKABLE void setKeyPressed(int keyIndex, bool pressed);
+signals:
+    void keyboardLayoutChanged();
+    void keyMaskChanged();
+    void highlightControllerChanged();
+protected:
+    QSGNode* updatePaintNode(QSGNode* oldNode, UpdatePaintNodeData* data) override;
+    void geometryChanged(const QRectF& newGeometry, const QRectF& oldGeometry) override;
+    void itemChange(ItemChange change, const ItemChangeData& value) override;
+private slots:
+    void updateLayout();
+    void updateEnabledKeys();
+    void setKeyHighlighted(int keyIndex, bool highlighted);
+    void pulse();
+private:
+    void updateHighlightedKeys();
+    void markKeyDirty(int keyIndex);
+    KeyboardRendererPrivate* d;
+    QPointer<KeyboardLayout> m_keyboardLayout;
+    QPointer<LessonKeyMask> m_keyMask;
+    QPointer<KeyboardHighlightController> m_highlightController;
+};
+
+#endif // KEYBOARDRENDERER_H
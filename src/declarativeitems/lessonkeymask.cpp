@@ -0,0 +1,196 @@
+/*
+ *  Copyright 2026  Sebastian Gottfried <sebastian.gottfried@posteo.de>
+ *
+ *  This program is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU General Public License as
+ *  published by the Free Software Foundation; either version 2 of
+ *  the License, or (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "lessonkeymask.h"
+
+#include <QSet>
+
+#include "core/characterset.h"
+#include "core/keyboardlayout.h"
+#include "core/lesson.h"
+#include "core/specialkey.h"
+#include "preferencescache.h"
+
+LessonKeyMask::LessonKeyMask(QObject* parent) :
+    QObject(parent)
+{
+    connect(PreferencesCache::instance(), &PreferencesCache::snapshotChanged, this, &LessonKeyMask::update);
+}
+
+KeyboardLayout* LessonKeyMask::keyboardLayout() const
+{
+    return m_keyboardLayout;
+}
+
+void LessonKeyMask::setKeyboardLayout(KeyboardLayout* keyboardLayout)
+{
+    if (keyboardLayout != m_keyboardLayout)
+    {
+        if (m_keyboardLayout)
+        {
+            m_keyboardLayout->disconnect(this);
+        }
+
+        m_keyboardLayout = keyboardLayout;
+
+        if (m_keyboardLayout)
+        {
+            connect(m_keyboardLayout, &KeyboardLayout::keyCountChanged, this, &LessonKeyMask::clearCache);
+            connect(m_keyboardLayout, &KeyboardLayout::isValidChanged, this, &LessonKeyMask::clearCache);
+        }
+
+        clearCache();
+        emit keyboardLayoutChanged();
+    }
+}
+
+Lesson* LessonKeyMask::lesson() const
+{
+    return m_lesson;
+}
+
+void LessonKeyMask::setLesson(Lesson* lesson)
+{
+    if (lesson != m_lesson)
+    {
+        if (m_lesson)
+        {
+            m_lesson->disconnect(this);
+        }
+
+        m_lesson = lesson;
+
+        if (m_lesson)
+        {
+            connect(m_lesson, &Lesson::charactersChanged, this, &LessonKeyMask::update);
+        }
+
+        update();
+        emit lessonChanged();
+    }
+}
+
+QList<bool> LessonKeyMask::enabledKeys() const
+{
+    return m_enabledKeys;
+}
+
+void LessonKeyMask::clearCache()
+{
+    m_cache.clear();
+    update();
+}
+
+void LessonKeyMask::update()
+{
+    QList<bool> enabledKeys;
+
+    if (m_keyboardLayout && m_keyboardLayout->isValid() && m_lesson)
+    {
+        const bool nextLineWithSpace = PreferencesCache::snapshot().nextLineWithSpace;
+        const QString cacheKey = m_lesson->characters() + (nextLineWithSpace? QLatin1Char('1'): QLatin1Char('0'));
+        auto it = m_cache.constFind(cacheKey);
+
+        if (it == m_cache.constEnd())
+        {
+            it = m_cache.insert(cacheKey, computeMask(m_lesson->characters(), nextLineWithSpace));
+        }
+
+        enabledKeys = it.value();
+    }
+
+    if (enabledKeys != m_enabledKeys)
+    {
+        m_enabledKeys = enabledKeys;
+        emit enabledKeysChanged();
+    }
+}
+
+QList<bool> LessonKeyMask::computeMask(const QString& characters, bool nextLineWithSpace) const
+{
+    const int keyCount = m_keyboardLayout->keyCount();
+    QList<bool> mask;
+    QSet<QString> usedModifiers;
+
+    mask.reserve(keyCount);
+
+    for (int i = 0; i < keyCount; i++)
+    {
+        SpecialKey* const specialKey = qobject_cast<SpecialKey*>(m_keyboardLayout->key(i));
+
+        if (!specialKey)
+        {
+            mask.append(false);
+            continue;
+        }
+
+        switch (specialKey->type())
+        {
+        case SpecialKey::Return:
+            mask.append(!nextLineWithSpace);
+            break;
+        case SpecialKey::Backspace:
+        case SpecialKey::Space:
+            mask.append(true);
+            break;
+        default:
+            // modifiers, decided below
+            mask.append(false);
+            break;
+        }
+    }
+
+    const CharacterSet& layoutCharacters = m_keyboardLayout->characterSet();
+    CharacterSet seenCharacters;
+
+    foreach (QChar character, characters)
+    {
+        // characters on no character key enable nothing, space is always on
+        if (!layoutCharacters.contains(character) || !seenCharacters.insert(character.unicode()))
+            continue;
+
+        const QString text(character);
+
+        foreach (int keyIndex, m_keyboardLayout->findKeyIndexes(text, -1))
+        {
+            mask[keyIndex] = true;
+
+            const QString modifierId = m_keyboardLayout->modifierIdForCharacter(text, keyIndex);
+
+            if (!modifierId.isEmpty())
+            {
+                usedModifiers.insert(modifierId);
+            }
+        }
+    }
+
+    // a modifier can be on more than one key, e.g. both shift keys
+    if (!usedModifiers.isEmpty())
+    {
+        for (int i = 0; i < keyCount; i++)
+        {
+            SpecialKey* const specialKey = qobject_cast<SpecialKey*>(m_keyboardLayout->key(i));
+
+            if (specialKey && usedModifiers.contains(specialKey->modifierId()))
+            {
+                mask[i] = true;
+            }
+        }
+    }
+
+    return mask;
+}
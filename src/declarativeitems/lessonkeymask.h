@@ -0,0 +1,66 @@
+/*
+ *  Copyright 2026  Sebastian Gottfried <sebastian.gottfried@posteo.de>
+ *
+ *  This program is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU General Public License as
+ *  published by the Free Software Foundation; either version 2 of
+ *  the License, or (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef LESSONKEYMASK_H
+#define LESSONKEYMASK_H
+
+#include <QObject>
+
+#include <QHash>
+#include <QList>
+#include <QPointer>
+
+class KeyboardLayout;
+class Lesson;
+
+/**
+ * Tells which keys of a keyboard layout are needed for a lesson.
+ *
+ * A key is enabled if it carries one of the lesson's characters, a modifier
+ * key if one of those characters needs it. Return, backspace and space are
+ * always enabled, except return when lines are finished with space. Masks
+ * are cached by the lesson's character set until the layout changes.
+ */
+class LessonKeyMask : public QObject
+{
+    Q_OBJECT
+    Q_PROPERTY(KeyboardLayout* keyboardLayout READ keyboardLayout WRITE setKeyboardLayout NOTIFY keyboardLayoutChanged)
+    Q_PROPERTY(Lesson* lesson READ lesson WRITE setLesson NOTIFY lessonChanged)
+    Q_PROPERTY(QList<bool> enabledKeys READ enabledKeys NOTIFY enabledKeysChanged)
+public:
+    explicit LessonKeyMask(QObject* parent = 0);
+    KeyboardLayout* keyboardLayout() const;
+    void setKeyboardLayout(KeyboardLayout* keyboardLayout);
+    Lesson* lesson() const;
+    void setLesson(Lesson* lesson);
+    QList<bool> enabledKeys() const;
+signals:
+    void keyboardLayoutChanged();
+    void lessonChanged();
+    void enabledKeysChanged();
+private slots:
+    void clearCache();
+    void update();
+private:
+    QList<bool> computeMask(const QString& characters, bool nextLineWithSpace) const;
+    QPointer<KeyboardLayout> m_keyboardLayout;
+    QPointer<Lesson> m_lesson;
+    QList<bool> m_enabledKeys;
+    QHash<QString, QList<bool> > m_cache;
+};
+
+#endif // LESSONKEYMASK_H
@@ -19,18 +19,59 @@
 
 #include <qmath.h>
 #include <QAbstractTextDocumentLayout>
+#include <QFontMetricsF>
 #include <QPainter>
+#include <QTextBlock>
 #include <QTextCharFormat>
 #include <QTextCursor>
 #include <QTextDocument>
 #include <QTextFrame>
+#include <QVector>
 
 #include "core/lesson.h"
+#include "core/textkernels.h"
 #include "declarativeitems/traininglinecore.h"
 
+namespace
+{
+    // longer lessons only keep the lines around the training line in the document
+    const int windowedModeMinLineCount = 200;
+    const int windowLinesBefore = 20;
+    const int windowLinesAfter = 80;
+    // move the window before the training line gets close to its end
+    const int windowMinLookAhead = 10;
+}
+
+enum LessonPainterGlyphFormat
+{
+    TextGlyphFormat,
+    ErrorGlyphFormat,
+    PreeditGlyphFormat,
+    PlaceHolderGlyphFormat
+};
+
+struct LessonPainterGlyph
+{
+    QChar displayedChar;
+    LessonPainterGlyphFormat format;
+};
+
+struct LessonPainterTile
+{
+    LessonPainterTile():
+        dirty(true)
+    {
+    }
+
+    QImage image;
+    QRectF rect;
+    bool dirty;
+};
+
 struct LessonPainterPrivate
 {
-    LessonPainterPrivate()
+    LessonPainterPrivate():
+        tileDevicePixelRatio(0)
     {
         blockFormat.setLineHeight(200, QTextBlockFormat::ProportionalHeight);
 
@@ -61,18 +102,46 @@ struct LessonPainterPrivate
     QTextCharFormat errorCharFormat;
     QTextCharFormat preeditCharFromat;
     QTextCharFormat titleCharFormat;
+
+    // what is currently shown in the document for each position of the
+    // training line, so only the positions changed by a key press are touched
+    QVector<LessonPainterGlyph> lineGlyphs;
+
+    // one pre-rendered image per text block, so a key press only costs
+    // rasterizing the training line
+    QVector<LessonPainterTile> tiles;
+    qreal tileDevicePixelRatio;
+
+    const QTextCharFormat& charFormat(LessonPainterGlyphFormat format) const
+    {
+        switch (format)
+        {
+        case ErrorGlyphFormat:
+            return errorCharFormat;
+        case PreeditGlyphFormat:
+            return preeditCharFromat;
+        case PlaceHolderGlyphFormat:
+            return placeHolderCharFormat;
+        default:
+            return textCharFormat;
+        }
+    }
 };
 
 LessonPainter::LessonPainter(QQuickItem* parent) :
     QQuickPaintedItem(parent),
     d(new LessonPainterPrivate()),
+    m_lineCount(0),
     m_doc(new QTextDocument(this)),
     m_textScale(1.0),
     m_maximumWidth(0),
     m_maximumHeight(-1),
-    m_imageCacheDirty(false),
     m_trainingLineCore(0),
-    m_currentLine(0)
+    m_currentLine(0),
+    m_windowStart(0),
+    m_windowEnd(0),
+    m_maxLineWidth(0),
+    m_lineHeight(0)
 {
     this->setFlag(QQuickPaintedItem::ItemHasContents, true);
     m_doc->setUseDesignMetrics(true);
@@ -164,6 +233,12 @@ void LessonPainter::setTrainingLineCore(TrainingLineCore* trainingLineCore)
             connect(m_trainingLineCore, &TrainingLineCore::preeditStringChanged, this, &LessonPainter::updateTrainingStatus);
             connect(m_trainingLineCore, &TrainingLineCore::done, this, &LessonPainter::advanceToNextTrainingLine);
         }
+
+        // untyped lines are shown as placeholders only with a training line
+        if (m_lesson)
+        {
+            updateDoc();
+        }
     }
 }
 
@@ -174,32 +249,71 @@ QRectF LessonPainter::cursorRectangle() const
 
 void LessonPainter::reset()
 {
-    m_lines = m_lesson? m_lesson->text().split('\n'): QStringList();
+    // builds the line table of the lesson first, so the copy shares it
+    m_lineCount = m_lesson? m_lesson->lineCount(): 0;
+    m_lines = m_lesson? m_lesson->textIndex(): LessonTextIndex();
+    m_typedLines.clear();
+    m_maxLineWidth = 0;
+
+    if (isWindowed())
+    {
+        // lines outside of the window aren't laid out, estimate their width
+        const QFontMetricsF metrics(d->textCharFormat.font());
+
+        for (int i = 0; i < m_lineCount; i++)
+        {
+            m_maxLineWidth = qMax(m_maxLineWidth, metrics.horizontalAdvance(m_lines.line(i).toString()));
+        }
+    }
+
+    m_windowStart = m_windowEnd = 0;
+    moveWindow(0);
     updateDoc();
     resetTrainingStatus();
 }
 
 void LessonPainter::paint(QPainter* painter)
 {
-    if (m_imageCacheDirty)
+    if (width() <= 0)
+        return;
+
+    const qreal devicePixelRatio = painter->device()->width() / width();
+
+    if (devicePixelRatio != d->tileDevicePixelRatio)
     {
-        const auto device = painter->device();
-        QImage img(QSize(qFloor(device->width()), qFloor(device->height())), QImage::Format_ARGB32_Premultiplied);
-        img.setDevicePixelRatio(img.width() / width());
-        img.fill(Qt::transparent);
-        QPainter painter(&img);
-        painter.scale(m_textScale, m_textScale);
-        m_doc->drawContents(&painter);
-        m_imageCache = img;
-        m_imageCacheDirty = false;
+        invalidateTiles();
+        d->tileDevicePixelRatio = devicePixelRatio;
     }
 
-    painter->drawImage(0, 0, m_imageCache);
+    d->tiles.resize(m_doc->blockCount());
+
+    const QRectF clipRect = painter->clipBoundingRect();
+    int blockNumber = 0;
+
+    for (QTextBlock block = m_doc->begin(); block.isValid(); block = block.next(), blockNumber++)
+    {
+        const QRectF rect = tileRect(block);
+        const QPointF targetPos = (rect.topLeft() + blockOffset(blockNumber)) * m_textScale;
+
+        if (painter->hasClipping() && !clipRect.intersects(QRectF(targetPos, rect.size() * m_textScale)))
+            continue;
+
+        LessonPainterTile& tile = d->tiles[blockNumber];
+
+        if (tile.dirty || tile.rect != rect)
+        {
+            tile.image = renderTile(rect, devicePixelRatio);
+            tile.rect = rect;
+            tile.dirty = false;
+        }
+
+        painter->drawImage(targetPos, tile.image);
+    }
 }
 
 void LessonPainter::updateLayout()
 {
-    invalidateImageCache();
+    invalidateTiles();
 
     if (!m_lesson)
     {
@@ -211,8 +325,19 @@ void LessonPainter::updateLayout()
     // ### reset text width from previous run
     m_doc->setTextWidth(-1);
 
-    const qreal docWidth = m_doc->idealWidth();
-    const qreal docHeight = m_doc->size().height();
+    qreal docWidth = m_doc->idealWidth();
+    qreal docHeight = m_doc->size().height();
+
+    // all text lines have the same height, there is no wrapping
+    m_lineHeight = m_doc->blockCount() > 1?
+                m_doc->documentLayout()->blockBoundingRect(m_doc->findBlockByNumber(1)).height():
+                0;
+
+    if (isWindowed())
+    {
+        docWidth = qMax(docWidth, m_maxLineWidth + 2 * m_doc->documentMargin());
+        docHeight += (m_lineCount - (m_windowEnd - m_windowStart)) * m_lineHeight;
+    }
 
     m_textScale = m_maximumHeight != -1?
                 qMin(m_maximumWidth / docWidth, m_maximumHeight / docHeight):
@@ -229,17 +354,18 @@ void LessonPainter::updateLayout()
 
 void LessonPainter::resetTrainingStatus()
 {
-    if (!m_trainingLineCore || m_lines.length() == 0)
+    if (!m_trainingLineCore || m_lineCount == 0)
         return;
 
     m_trainingLineCore->reset();
     m_currentLine = 0;
-    m_trainingLineCore->setReferenceLine(m_lines[0]);
+    d->lineGlyphs.clear();
+    m_trainingLineCore->setReferenceLine(m_lines.line(0).toString());
 }
 
 void LessonPainter::updateTrainingStatus()
 {
-    if (m_currentLine >= m_lines.length())
+    if (m_currentLine >= m_lineCount)
         return;
 
     QTextCursor cursor(m_doc);
@@ -247,43 +373,86 @@ void LessonPainter::updateTrainingStatus()
     const QString referenceLine = m_trainingLineCore->referenceLine();
     const QString actualLine = m_trainingLineCore->actualLine();
     const QString preeditString = m_trainingLineCore->preeditString();
-    const QTextBlock block = m_doc->findBlockByNumber(m_currentLine + 1);
+    const int firstMismatch = m_trainingLineCore->firstMismatch();
+    // everything before the first mismatch is known to be correct
+    const int correctLength = firstMismatch == -1? actualLine.length(): firstMismatch;
+    const QTextBlock block = m_doc->findBlockByNumber(m_currentLine - m_windowStart + 1);
     const int blockPosition = block.position();
 
+    if (d->lineGlyphs.length() != referenceLine.length())
+    {
+        // a new training line is shown as placeholders by updateDoc()
+        d->lineGlyphs.resize(referenceLine.length());
+
+        for (int linePos = 0; linePos < referenceLine.length(); linePos++)
+        {
+            const LessonPainterGlyph placeHolderGlyph = {referenceLine.at(linePos), PlaceHolderGlyphFormat};
+            d->lineGlyphs[linePos] = placeHolderGlyph;
+        }
+    }
+
+    bool docChanged = false;
+
     for (int linePos = 0; linePos < referenceLine.length(); linePos++)
     {
         const bool typed = linePos < actualLine.length();
         const bool preedit = !typed &&  linePos - actualLine.length() < preeditString.length();
-        const bool correct = typed && actualLine.at(linePos) == referenceLine.at(linePos);
+        const bool correct = typed && (linePos < correctLength || actualLine.at(linePos) == referenceLine.at(linePos));
 
-        const QTextCharFormat charFormat = typed?
-                    (correct? d->textCharFormat: d->errorCharFormat):
-                    (preedit? d->preeditCharFromat: d->placeHolderCharFormat);
+        const LessonPainterGlyphFormat format = typed?
+                    (correct? TextGlyphFormat: ErrorGlyphFormat):
+                    (preedit? PreeditGlyphFormat: PlaceHolderGlyphFormat);
 
         const QChar displayedChar = typed?
                     actualLine.at(linePos):
                     preedit? preeditString.at(linePos - actualLine.length()): referenceLine.at(linePos);
 
+        LessonPainterGlyph& glyph = d->lineGlyphs[linePos];
+
+        if (glyph.format == format && glyph.displayedChar == displayedChar)
+            continue;
+
         const int charPosition = blockPosition + linePos;
 
         cursor.setPosition(charPosition, QTextCursor::MoveAnchor);
         cursor.setPosition(charPosition + 1, QTextCursor::KeepAnchor);
-        cursor.deleteChar();
-        cursor.insertText(QString(displayedChar), charFormat);
+
+        if (glyph.displayedChar == displayedChar)
+        {
+            cursor.setCharFormat(d->charFormat(format));
+        }
+        else
+        {
+            cursor.insertText(QString(displayedChar), d->charFormat(format));
+        }
+
+        glyph.displayedChar = displayedChar;
+        glyph.format = format;
+        docChanged = true;
+    }
+
+    if (docChanged)
+    {
+        invalidateTile(block.blockNumber());
     }
 
-    invalidateImageCache();
     updateCursorRectangle();
-    update();
 }
 
 void LessonPainter::advanceToNextTrainingLine()
 {
+    m_typedLines.append(m_trainingLineCore->actualLine());
     m_currentLine++;
+    d->lineGlyphs.clear();
 
-    if (m_currentLine < m_lines.length())
+    if (moveWindow(m_currentLine))
     {
-        m_trainingLineCore->setReferenceLine(m_lines.at(m_currentLine));
+        updateDoc();
+    }
+
+    if (m_currentLine < m_lineCount)
+    {
+        m_trainingLineCore->setReferenceLine(m_lines.line(m_currentLine).toString());
     }
     else
     {
@@ -295,6 +464,7 @@ void LessonPainter::advanceToNextTrainingLine()
 void LessonPainter::updateDoc()
 {
     m_doc->clear();
+    d->lineGlyphs.clear();
 
     if (!m_lesson) {
         updateLayout();
@@ -315,49 +485,134 @@ void LessonPainter::updateDoc()
 
     const QTextCharFormat textFormat = m_trainingLineCore? d->placeHolderCharFormat: d->textCharFormat;
 
-    foreach (const QString& line, m_lines)
+    for (int i = m_windowStart; i < m_windowEnd; i++)
     {
+        const QStringView line = m_lines.line(i);
         blockFormat.setAlignment(line.isRightToLeft()? Qt::AlignRight: Qt::AlignLeft);
         cursor.insertBlock(d->blockFormat, textFormat);
-        cursor.insertText(line);
+
+        if (i < m_typedLines.length())
+        {
+            insertTypedLine(cursor, line, m_typedLines.at(i));
+        }
+        else
+        {
+            cursor.insertText(line.toString());
+        }
     }
 
 
     updateLayout();
 }
 
-void LessonPainter::invalidateImageCache()
+void LessonPainter::insertTypedLine(QTextCursor& cursor, QStringView referenceLine, const QString& actualLine)
 {
-    m_imageCacheDirty = true;
-    m_imageCache = QImage();
+    const int typedLength = qMin(int(referenceLine.length()), actualLine.length());
+    int linePos = 0;
+
+    // correct characters are inserted in runs, errors one by one
+    while (linePos < typedLength)
+    {
+        const int correctLength = TextKernels::mismatch(actualLine.constData() + linePos, referenceLine.data() + linePos, typedLength - linePos);
+
+        if (correctLength > 0)
+        {
+            cursor.insertText(actualLine.mid(linePos, correctLength), d->textCharFormat);
+            linePos += correctLength;
+        }
+
+        if (linePos < typedLength)
+        {
+            cursor.insertText(QString(actualLine.at(linePos)), d->errorCharFormat);
+            linePos++;
+        }
+    }
+
+    if (typedLength < referenceLine.length())
+    {
+        cursor.insertText(referenceLine.mid(typedLength).toString(), d->placeHolderCharFormat);
+    }
+}
+
+bool LessonPainter::moveWindow(int line)
+{
+    if (!isWindowed())
+    {
+        const bool changed = m_windowStart != 0 || m_windowEnd != m_lineCount;
+        m_windowStart = 0;
+        m_windowEnd = m_lineCount;
+        return changed;
+    }
+
+    if (m_windowEnd > m_windowStart && line >= m_windowStart && (line < m_windowEnd - windowMinLookAhead || m_windowEnd == m_lineCount))
+        return false;
+
+    m_windowStart = qMax(0, line - windowLinesBefore);
+    m_windowEnd = qMin(m_lineCount, line + windowLinesAfter);
+    return true;
+}
+
+bool LessonPainter::isWindowed() const
+{
+    return m_lineCount >= windowedModeMinLineCount;
+}
+
+QPointF LessonPainter::blockOffset(int blockNumber) const
+{
+    // the title block always stays on top
+    return blockNumber > 0? QPointF(0, m_windowStart * m_lineHeight): QPointF();
+}
+
+void LessonPainter::invalidateTiles()
+{
+    d->tiles.clear();
 }
 
-void LessonPainter::checkImageCache()
+void LessonPainter::invalidateTile(int blockNumber)
 {
-    if (!m_imageCacheDirty)
+    if (blockNumber >= d->tiles.length())
+    {
+        update();
         return;
+    }
+
+    d->tiles[blockNumber].dirty = true;
 
-    QImage img(QSize(qFloor(width()), qFloor(height())), QImage::Format_ARGB32_Premultiplied);
+    const QRectF rect = tileRect(m_doc->findBlockByNumber(blockNumber));
+    update(QRectF((rect.topLeft() + blockOffset(blockNumber)) * m_textScale, rect.size() * m_textScale).toAlignedRect());
+}
+
+QRectF LessonPainter::tileRect(const QTextBlock& block) const
+{
+    // span the whole document width, otherwise the block alignment is lost
+    const QRectF blockRect = m_doc->documentLayout()->blockBoundingRect(block);
+    return QRectF(0, blockRect.y(), m_doc->size().width(), blockRect.height());
+}
+
+QImage LessonPainter::renderTile(const QRectF& tileRect, qreal devicePixelRatio) const
+{
+    const QSizeF size = tileRect.size() * m_textScale * devicePixelRatio;
+    QImage img(QSize(qCeil(size.width()), qCeil(size.height())), QImage::Format_ARGB32_Premultiplied);
+    img.setDevicePixelRatio(devicePixelRatio);
     img.fill(Qt::transparent);
     QPainter painter(&img);
     painter.scale(m_textScale, m_textScale);
-    m_doc->drawContents(&painter);
-
-    m_imageCache = img;
-    m_imageCacheDirty = false;
+    painter.translate(-tileRect.topLeft());
+    m_doc->drawContents(&painter, tileRect);
+    return img;
 }
 
 void LessonPainter::updateCursorRectangle()
 {
-    if (!m_trainingLineCore || m_lines.length() == 0 || m_currentLine >= m_lines.length())
+    if (!m_trainingLineCore || m_lineCount == 0 || m_currentLine >= m_lineCount)
         return;
 
     const QString actualLine = m_trainingLineCore->actualLine();
     const QString preeditString = m_trainingLineCore->preeditString();
-    const QTextBlock block = m_doc->findBlockByNumber(m_currentLine + 1);
+    const QTextBlock block = m_doc->findBlockByNumber(m_currentLine - m_windowStart + 1);
     const QAbstractTextDocumentLayout* docLayout = m_doc->documentLayout();
     const QTextLayout* layout = block.layout();
-    const QPointF blockPos = docLayout->blockBoundingRect(block).topLeft();
+    const QPointF blockPos = docLayout->blockBoundingRect(block).topLeft() + blockOffset(block.blockNumber());
     const int relCursorPos = actualLine.length() + preeditString.length();
     const QTextLine line = layout->lineForTextPosition(relCursorPos);
 
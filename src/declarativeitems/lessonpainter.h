@@ -23,6 +23,10 @@
 
 #include <QPointer>
 
+#include "core/lessontextindex.h"
+
+class QTextBlock;
+class QTextCursor;
 class QTextDocument;
 
 class Lesson;
@@ -67,20 +71,30 @@ private slots:
     void advanceToNextTrainingLine();
 private:
     void updateDoc();
-    void invalidateImageCache();
-    void checkImageCache();
+    void insertTypedLine(QTextCursor& cursor, QStringView referenceLine, const QString& actualLine);
+    bool moveWindow(int line);
+    bool isWindowed() const;
+    QPointF blockOffset(int blockNumber) const;
+    void invalidateTiles();
+    void invalidateTile(int blockNumber);
+    QRectF tileRect(const QTextBlock& block) const;
+    QImage renderTile(const QRectF& tileRect, qreal devicePixelRatio) const;
     void updateCursorRectangle();
     LessonPainterPrivate* d;
     QPointer<Lesson> m_lesson;
-    QStringList m_lines;
+    LessonTextIndex m_lines;
+    int m_lineCount;
+    QStringList m_typedLines;
     QTextDocument* m_doc;
     qreal m_textScale;
     qreal m_maximumWidth;
     qreal m_maximumHeight;
-    QImage m_imageCache;
-    bool m_imageCacheDirty;
     TrainingLineCore* m_trainingLineCore;
     int m_currentLine;
+    int m_windowStart;
+    int m_windowEnd;
+    qreal m_maxLineWidth;
+    qreal m_lineHeight;
     QPointer<QQuickItem> m_cursorItem;
     QRectF m_cursorRectangle;
 };
@@ -0,0 +1,791 @@
+/*
+ *  Copyright 2026  Sebastian Gottfried <sebastian.gottfried@posteo.de>
+ *
+ *  This program is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU General Public License as
+ *  published by the Free Software Foundation; either version 2 of
+ *  the License, or (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "lessonrenderer.h"
+
+#include <qmath.h>
+#include <QFontMetricsF>
+#include <QGlyphRun>
+#include <QQuickWindow>
+#include <QSet>
+#include <QSGFlatColorMaterial>
+#include <QSGGeometryNode>
+#include <QSGTexture>
+#include <QTextLayout>
+#include <QVector>
+
+#include "core/lesson.h"
+#include "declarativeitems/glyphatlas.h"
+#include "declarativeitems/traininglinecore.h"
+
+enum LessonRendererGlyphFormat
+{
+    TitleGlyphFormat,
+    TextGlyphFormat,
+    ErrorGlyphFormat,
+    PreeditGlyphFormat,
+    PlaceHolderGlyphFormat
+};
+
+struct LessonRendererGlyph
+{
+    int fontIndex;
+    quint32 glyphIndex;
+    // origin of the glyph on the baseline, in device pixels
+    QPointF position;
+    int linePos;
+};
+
+struct LessonRendererLine
+{
+    LessonRendererLine():
+        y(0),
+        height(0),
+        textHeight(0),
+        baseline(0),
+        width(0),
+        underlinePos(0),
+        underlineWidth(1),
+        dirty(true)
+    {
+    }
+
+    QString text;
+    QVector<LessonRendererGlyphFormat> formats;
+    // all geometry is in device pixels
+    qreal y;
+    qreal height;
+    qreal textHeight;
+    qreal baseline;
+    qreal width;
+    qreal underlinePos;
+    qreal underlineWidth;
+    QVector<qreal> cursorX;
+    QVector<LessonRendererGlyph> glyphs;
+    QVector<QRectF> underlines;
+    QVector<QRectF> backgrounds;
+    bool dirty;
+};
+
+namespace
+{
+    const qreal documentMargin = 20.0;
+    // the line geometry uses 16 bit indices
+    const int maxQuadsPerLine = 0xffff / 4;
+
+    quint64 glyphKey(int fontIndex, quint32 glyphIndex)
+    {
+        return (quint64(fontIndex) << 32) | glyphIndex;
+    }
+
+    QRgb glyphColor(LessonRendererGlyphFormat format)
+    {
+        return format == PlaceHolderGlyphFormat? qRgb(0x88, 0x88, 0x88): qRgb(0, 0, 0);
+    }
+
+    QSGGeometryNode* createRectsNode(const QColor& color)
+    {
+        QSGGeometry* geometry = new QSGGeometry(QSGGeometry::defaultAttributes_Point2D(), 0);
+        geometry->setDrawingMode(QSGGeometry::DrawTriangles);
+        QSGFlatColorMaterial* material = new QSGFlatColorMaterial();
+        material->setColor(color);
+
+        QSGGeometryNode* node = new QSGGeometryNode();
+        node->setGeometry(geometry);
+        node->setFlag(QSGNode::OwnsGeometry);
+        node->setMaterial(material);
+        node->setFlag(QSGNode::OwnsMaterial);
+        return node;
+    }
+
+    void setRects(QSGGeometryNode* node, const QVector<QRectF>& rects)
+    {
+        QSGGeometry* geometry = node->geometry();
+        geometry->allocate(rects.length() * 6);
+        QSGGeometry::Point2D* vertices = geometry->vertexDataAsPoint2D();
+
+        foreach (const QRectF& rect, rects)
+        {
+            (vertices++)->set(rect.left(), rect.top());
+            (vertices++)->set(rect.right(), rect.top());
+            (vertices++)->set(rect.left(), rect.bottom());
+            (vertices++)->set(rect.right(), rect.top());
+            (vertices++)->set(rect.right(), rect.bottom());
+            (vertices++)->set(rect.left(), rect.bottom());
+        }
+
+        node->markDirty(QSGNode::DirtyGeometry);
+    }
+
+    class LessonNode : public QSGNode
+    {
+    public:
+        LessonNode():
+            backgroundNode(createRectsNode(QColor("#d0d0d0"))),
+            linesNode(new QSGNode()),
+            underlineNode(createRectsNode(QColor("#f00"))),
+            atlasTexture(0)
+        {
+            appendChildNode(backgroundNode);
+            appendChildNode(linesNode);
+            appendChildNode(underlineNode);
+        }
+
+        ~LessonNode()
+        {
+            // the line nodes share the glyph material owned by this node
+            qDeleteAll(lineNodes);
+            delete atlasTexture;
+        }
+
+        void setLineCount(int count)
+        {
+            while (lineNodes.length() > count)
+            {
+                delete lineNodes.takeLast();
+            }
+
+            while (lineNodes.length() < count)
+            {
+                QSGGeometry* geometry = new QSGGeometry(glyphAttributes(), 0, 0, QSGGeometry::UnsignedShortType);
+                geometry->setDrawingMode(QSGGeometry::DrawTriangles);
+
+                QSGGeometryNode* lineNode = new QSGGeometryNode();
+                lineNode->setGeometry(geometry);
+                lineNode->setFlag(QSGNode::OwnsGeometry);
+                lineNode->setMaterial(&glyphMaterial);
+                linesNode->appendChildNode(lineNode);
+                lineNodes.append(lineNode);
+            }
+        }
+
+        void setAtlasTexture(QSGTexture* texture)
+        {
+            delete atlasTexture;
+            atlasTexture = texture;
+            glyphMaterial.setTexture(texture);
+
+            foreach (QSGGeometryNode* lineNode, lineNodes)
+            {
+                lineNode->markDirty(QSGNode::DirtyMaterial);
+            }
+        }
+
+        QSGGeometryNode* backgroundNode;
+        QSGNode* linesNode;
+        QSGGeometryNode* underlineNode;
+        QVector<QSGGeometryNode*> lineNodes;
+        GlyphMaterial glyphMaterial;
+        QSGTexture* atlasTexture;
+    };
+}
+
+struct LessonRendererPrivate
+{
+    LessonRendererPrivate():
+        devicePixelRatio(1.0),
+        margin(0),
+        atlasDirty(true),
+        structureDirty(true),
+        decorationsDirty(true)
+    {
+        textFont.setFamily(QStringLiteral("monospace"));
+        textFont.setPointSizeF(10);
+        textFont.setHintingPreference(QFont::PreferVerticalHinting);
+
+        titleFont.setFamily(QStringLiteral("sans-serif"));
+        titleFont.setPointSizeF(15);
+        titleFont.setHintingPreference(QFont::PreferVerticalHinting);
+    }
+
+    void resetAtlas()
+    {
+        atlas.clear();
+        atlasDirty = true;
+    }
+
+    void updateLineGeometry(QSGGeometryNode* node, const LessonRendererLine& line) const
+    {
+        int quadCount = 0;
+
+        foreach (const LessonRendererGlyph& glyph, line.glyphs)
+        {
+            if (!atlas.glyph(glyph.fontIndex, glyph.glyphIndex).rect.isEmpty())
+            {
+                quadCount++;
+            }
+        }
+
+        quadCount = qMin(quadCount, maxQuadsPerLine);
+
+        QSGGeometry* geometry = node->geometry();
+        geometry->allocate(quadCount * 4, quadCount * 6);
+        GlyphVertex* vertices = static_cast<GlyphVertex*>(geometry->vertexData());
+        quint16* indices = geometry->indexDataAsUShort();
+        int quad = 0;
+
+        foreach (const LessonRendererGlyph& glyph, line.glyphs)
+        {
+            if (quad == quadCount)
+                break;
+
+            const GlyphAtlas::Glyph atlasGlyph = atlas.glyph(glyph.fontIndex, glyph.glyphIndex);
+
+            if (atlasGlyph.rect.isEmpty())
+                continue;
+
+            // glyphs are rasterized at integer positions, so snap them to the pixel grid
+            const QPoint devicePos = QPoint(qRound(glyph.position.x()), qRound(glyph.position.y())) + atlasGlyph.offset;
+            const QRectF rect(QPointF(devicePos) / devicePixelRatio, QSizeF(atlasGlyph.rect.size()) / devicePixelRatio);
+            const QRectF textureRect = atlas.textureRect(atlasGlyph.rect);
+            const QRgb color = glyphColor(line.formats.value(glyph.linePos, TextGlyphFormat));
+
+            vertices[0].set(rect.topLeft(), textureRect.topLeft(), color);
+            vertices[1].set(rect.topRight(), textureRect.topRight(), color);
+            vertices[2].set(rect.bottomLeft(), textureRect.bottomLeft(), color);
+            vertices[3].set(rect.bottomRight(), textureRect.bottomRight(), color);
+
+            const quint16 first = quad * 4;
+            indices[0] = first;
+            indices[1] = first + 1;
+            indices[2] = first + 2;
+            indices[3] = first + 1;
+            indices[4] = first + 3;
+            indices[5] = first + 2;
+
+            vertices += 4;
+            indices += 6;
+            quad++;
+        }
+
+        node->markDirty(QSGNode::DirtyGeometry);
+    }
+
+    QFont textFont;
+    QFont titleFont;
+    QFont scaledTextFont;
+    QFont scaledTitleFont;
+    qreal devicePixelRatio;
+    qreal margin;
+    QVector<LessonRendererLine> lines;
+    GlyphAtlas atlas;
+    bool atlasDirty;
+    bool structureDirty;
+    bool decorationsDirty;
+};
+
+LessonRenderer::LessonRenderer(QQuickItem* parent) :
+    QQuickItem(parent),
+    d(new LessonRendererPrivate()),
+    m_lineCount(0),
+    m_textScale(1.0),
+    m_maximumWidth(0),
+    m_maximumHeight(-1),
+    m_trainingLineCore(0),
+    m_currentLine(0)
+{
+    setFlag(QQuickItem::ItemHasContents, true);
+}
+
+LessonRenderer::~LessonRenderer()
+{
+    delete d;
+}
+
+Lesson* LessonRenderer::lesson() const
+{
+    return m_lesson;
+}
+
+void LessonRenderer::setLesson(Lesson* lesson)
+{
+    if (lesson != m_lesson)
+    {
+        if (m_lesson)
+        {
+            m_lesson->disconnect(this);
+        }
+
+        m_lesson = lesson;
+
+        if (m_lesson)
+        {
+            connect(m_lesson.data(), &Lesson::titleChanged, this, &LessonRenderer::reset);
+            connect(m_lesson.data(), &Lesson::textChanged, this, &LessonRenderer::reset);
+        }
+
+        reset();
+
+        emit lessonChanged();
+    }
+}
+
+qreal LessonRenderer::maximumWidth() const
+{
+    return m_maximumWidth;
+}
+
+void LessonRenderer::setMaximumWidth(qreal maximumWidth)
+{
+    if (maximumWidth != m_maximumWidth)
+    {
+        m_maximumWidth = maximumWidth;
+        emit maximumWidthChanged();
+        updateLayout();
+    }
+}
+
+qreal LessonRenderer::maximumHeight() const
+{
+    return m_maximumHeight;
+}
+
+void LessonRenderer::setMaximumHeight(qreal maximumHeight)
+{
+    if (maximumHeight != m_maximumHeight)
+    {
+        m_maximumHeight = maximumHeight;
+        emit maximumHeightChanged();
+        updateLayout();
+    }
+}
+
+TrainingLineCore* LessonRenderer::trainingLineCore() const
+{
+    return m_trainingLineCore;
+}
+
+void LessonRenderer::setTrainingLineCore(TrainingLineCore* trainingLineCore)
+{
+    if (trainingLineCore != m_trainingLineCore)
+    {
+        if (m_trainingLineCore)
+        {
+            m_trainingLineCore->disconnect(this);
+        }
+
+        m_trainingLineCore = trainingLineCore;
+        emit trainingLineCoreChanged();
+
+        if (m_trainingLineCore)
+        {
+            connect(m_trainingLineCore, &TrainingLineCore::actualLineChanged, this, &LessonRenderer::updateTrainingStatus);
+            connect(m_trainingLineCore, &TrainingLineCore::preeditStringChanged, this, &LessonRenderer::updateTrainingStatus);
+            connect(m_trainingLineCore, &TrainingLineCore::done, this, &LessonRenderer::advanceToNextTrainingLine);
+        }
+    }
+}
+
+QRectF LessonRenderer::cursorRectangle() const
+{
+    return m_cursorRectangle;
+}
+
+void LessonRenderer::reset()
+{
+    // builds the line table of the lesson first, so the copy shares it
+    m_lineCount = m_lesson? m_lesson->lineCount(): 0;
+    m_lines = m_lesson? m_lesson->textIndex(): LessonTextIndex();
+    d->lines.clear();
+    updateLayout();
+    resetTrainingStatus();
+}
+
+QSGNode* LessonRenderer::updatePaintNode(QSGNode* oldNode, UpdatePaintNodeData* data)
+{
+    Q_UNUSED(data)
+
+    LessonNode* node = static_cast<LessonNode*>(oldNode);
+
+    if (d->lines.isEmpty())
+    {
+        delete node;
+        return 0;
+    }
+
+    if (!node)
+    {
+        node = new LessonNode();
+        d->atlasDirty = true;
+        d->structureDirty = true;
+        d->decorationsDirty = true;
+    }
+
+    if (d->atlasDirty || d->atlas.isDirty())
+    {
+        if (!d->atlas.image().isNull())
+        {
+            node->setAtlasTexture(d->atlas.createTexture(window()));
+        }
+
+        d->atlasDirty = false;
+    }
+
+    if (d->structureDirty)
+    {
+        node->setLineCount(d->lines.length());
+
+        for (int i = 0; i < d->lines.length(); i++)
+        {
+            d->lines[i].dirty = true;
+        }
+
+        d->structureDirty = false;
+    }
+
+    for (int i = 0; i < d->lines.length(); i++)
+    {
+        LessonRendererLine& line = d->lines[i];
+
+        if (line.dirty)
+        {
+            d->updateLineGeometry(node->lineNodes.at(i), line);
+            line.dirty = false;
+        }
+    }
+
+    if (d->decorationsDirty)
+    {
+        QVector<QRectF> backgrounds;
+        QVector<QRectF> underlines;
+
+        foreach (const LessonRendererLine& line, d->lines)
+        {
+            foreach (const QRectF& rect, line.backgrounds)
+            {
+                backgrounds.append(QRectF(rect.topLeft() / d->devicePixelRatio, rect.size() / d->devicePixelRatio));
+            }
+
+            foreach (const QRectF& rect, line.underlines)
+            {
+                underlines.append(QRectF(rect.topLeft() / d->devicePixelRatio, rect.size() / d->devicePixelRatio));
+            }
+        }
+
+        setRects(node->backgroundNode, backgrounds);
+        setRects(node->underlineNode, underlines);
+        d->decorationsDirty = false;
+    }
+
+    return node;
+}
+
+void LessonRenderer::itemChange(ItemChange change, const ItemChangeData& value)
+{
+    if (change == ItemSceneChange || change == ItemDevicePixelRatioHasChanged)
+    {
+        updateLayout();
+    }
+
+    QQuickItem::itemChange(change, value);
+}
+
+void LessonRenderer::updateLayout()
+{
+    d->structureDirty = true;
+    d->decorationsDirty = true;
+
+    if (!m_lesson || m_maximumWidth <= 0)
+    {
+        d->lines.clear();
+        d->resetAtlas();
+        setWidth(0);
+        setHeight(0);
+        update();
+        return;
+    }
+
+    d->devicePixelRatio = window()? window()->effectiveDevicePixelRatio(): 1.0;
+
+    // measure at the natural size first, the glyphs are only needed at the final scale
+    const QSizeF docSize = layoutLines(1.0, false);
+
+    m_textScale = m_maximumHeight != -1?
+                qMin(m_maximumWidth / docSize.width(), m_maximumHeight / docSize.height()):
+                m_maximumWidth / docSize.width();
+
+    layoutLines(m_textScale, true);
+
+    setWidth(qCeil(docSize.width() * m_textScale));
+    setHeight(qCeil(docSize.height() * m_textScale));
+
+    updateCursorRectangle();
+    update();
+}
+
+void LessonRenderer::resetTrainingStatus()
+{
+    if (!m_trainingLineCore || m_lineCount == 0)
+        return;
+
+    m_trainingLineCore->reset();
+    m_currentLine = 0;
+    m_trainingLineCore->setReferenceLine(m_lines.line(0).toString());
+}
+
+void LessonRenderer::updateTrainingStatus()
+{
+    if (m_currentLine >= m_lineCount || m_currentLine + 1 >= d->lines.length())
+        return;
+
+    const QString referenceLine = m_trainingLineCore->referenceLine();
+    const QString actualLine = m_trainingLineCore->actualLine();
+    const QString preeditString = m_trainingLineCore->preeditString();
+    const int firstMismatch = m_trainingLineCore->firstMismatch();
+    // everything before the first mismatch is known to be correct
+    const int correctLength = firstMismatch == -1? actualLine.length(): firstMismatch;
+    LessonRendererLine& line = d->lines[m_currentLine + 1];
+
+    QString displayedText = referenceLine;
+    QVector<LessonRendererGlyphFormat> formats(referenceLine.length());
+
+    for (int linePos = 0; linePos < referenceLine.length(); linePos++)
+    {
+        const bool typed = linePos < actualLine.length();
+        const bool preedit = !typed &&  linePos - actualLine.length() < preeditString.length();
+        const bool correct = typed && (linePos < correctLength || actualLine.at(linePos) == referenceLine.at(linePos));
+
+        formats[linePos] = typed?
+                    (correct? TextGlyphFormat: ErrorGlyphFormat):
+                    (preedit? PreeditGlyphFormat: PlaceHolderGlyphFormat);
+
+        displayedText[linePos] = typed?
+                    actualLine.at(linePos):
+                    preedit? preeditString.at(linePos - actualLine.length()): referenceLine.at(linePos);
+    }
+
+    if (displayedText == line.text && formats == line.formats)
+    {
+        updateCursorRectangle();
+        return;
+    }
+
+    line.formats = formats;
+
+    // a different character needs new glyphs, otherwise only the colors change
+    if (displayedText != line.text)
+    {
+        line.text = displayedText;
+        layoutLine(line, d->scaledTextFont, line.y, true);
+    }
+
+    updateDecorations(line);
+    line.dirty = true;
+    update();
+
+    updateCursorRectangle();
+}
+
+void LessonRenderer::advanceToNextTrainingLine()
+{
+    m_currentLine++;
+
+    if (m_currentLine < m_lineCount)
+    {
+        m_trainingLineCore->setReferenceLine(m_lines.line(m_currentLine).toString());
+    }
+    else
+    {
+        m_trainingLineCore->setReferenceLine(QString());
+        emit done();
+    }
+}
+
+QSizeF LessonRenderer::layoutLines(qreal scale, bool withGlyphs)
+{
+    const qreal deviceScale = scale * d->devicePixelRatio;
+    const int lineCount = m_lineCount + 1;
+
+    d->scaledTextFont = d->textFont;
+    d->scaledTextFont.setPointSizeF(d->textFont.pointSizeF() * deviceScale);
+    d->scaledTitleFont = d->titleFont;
+    d->scaledTitleFont.setPointSizeF(d->titleFont.pointSizeF() * deviceScale);
+    d->margin = documentMargin * deviceScale;
+    d->resetAtlas();
+
+    // keep the training progress when only the scale changes
+    if (d->lines.length() != lineCount)
+    {
+        const LessonRendererGlyphFormat textFormat = m_trainingLineCore? PlaceHolderGlyphFormat: TextGlyphFormat;
+
+        d->lines.clear();
+        d->lines.resize(lineCount);
+
+        for (int i = 0; i < lineCount; i++)
+        {
+            LessonRendererLine& line = d->lines[i];
+            line.text = i == 0? m_lesson->title(): m_lines.line(i - 1).toString();
+            line.formats.fill(i == 0? TitleGlyphFormat: textFormat, line.text.length());
+        }
+    }
+
+    qreal y = d->margin;
+    qreal width = 0;
+
+    for (int i = 0; i < lineCount; i++)
+    {
+        LessonRendererLine& line = d->lines[i];
+        layoutLine(line, i == 0? d->scaledTitleFont: d->scaledTextFont, y, withGlyphs);
+        updateDecorations(line);
+        line.dirty = true;
+        y += line.height;
+        width = qMax(width, line.width);
+    }
+
+    return QSizeF(width + 2 * d->margin, y + d->margin) / d->devicePixelRatio;
+}
+
+void LessonRenderer::layoutLine(LessonRendererLine& line, const QFont& font, qreal y, bool withGlyphs)
+{
+    QTextOption option;
+    option.setWrapMode(QTextOption::NoWrap);
+    option.setAlignment(Qt::AlignLeft | Qt::AlignAbsolute);
+    option.setTextDirection(line.text.isRightToLeft()? Qt::RightToLeft: Qt::LeftToRight);
+
+    QTextLayout layout(line.text, font);
+    layout.setTextOption(option);
+    layout.setCacheEnabled(true);
+    layout.beginLayout();
+    QTextLine textLine = layout.createLine();
+    textLine.setNumColumns(line.text.length());
+    textLine.setPosition(QPointF(0, 0));
+    layout.endLayout();
+
+    const QFontMetricsF metrics(font);
+
+    line.y = y;
+    line.textHeight = textLine.height();
+    // same line spacing as LessonPainter with its proportional line height of 200 %
+    line.height = 2 * line.textHeight;
+    line.baseline = y + textLine.ascent();
+    line.width = textLine.naturalTextWidth();
+    line.underlinePos = metrics.underlinePos();
+    line.underlineWidth = qMax(qreal(1.0), metrics.lineWidth());
+
+    line.cursorX.resize(line.text.length() + 1);
+
+    for (int i = 0; i <= line.text.length(); i++)
+    {
+        line.cursorX[i] = d->margin + textLine.cursorToX(i);
+    }
+
+    line.glyphs.clear();
+
+    if (!withGlyphs)
+        return;
+
+    // characters of the same cluster share their glyphs
+    QSet<QPair<quint64, qint64> > seenGlyphs;
+
+    for (int linePos = 0; linePos < line.text.length(); linePos++)
+    {
+        foreach (const QGlyphRun& glyphRun, layout.glyphRuns(linePos, 1))
+        {
+            const int fontIndex = d->atlas.fontIndex(glyphRun.rawFont());
+            const QVector<quint32> glyphIndexes = glyphRun.glyphIndexes();
+            const QVector<QPointF> positions = glyphRun.positions();
+
+            for (int i = 0; i < glyphIndexes.length(); i++)
+            {
+                const quint64 key = glyphKey(fontIndex, glyphIndexes.at(i));
+                const QPair<quint64, qint64> seenKey(key, qRound64(positions.at(i).x() * 64));
+
+                if (seenGlyphs.contains(seenKey))
+                    continue;
+
+                seenGlyphs.insert(seenKey);
+
+                // the texture coordinates are relative to the atlas size
+                if (d->atlas.addGlyph(fontIndex, glyphIndexes.at(i)))
+                {
+                    for (int j = 0; j < d->lines.length(); j++)
+                    {
+                        d->lines[j].dirty = true;
+                    }
+                }
+
+                const LessonRendererGlyph glyph = {
+                    fontIndex,
+                    glyphIndexes.at(i),
+                    QPointF(d->margin + positions.at(i).x(), y + positions.at(i).y()),
+                    linePos
+                };
+                line.glyphs.append(glyph);
+            }
+        }
+    }
+}
+
+void LessonRenderer::updateDecorations(LessonRendererLine& line)
+{
+    line.underlines.clear();
+    line.backgrounds.clear();
+
+    int linePos = 0;
+
+    while (linePos < line.formats.length())
+    {
+        const LessonRendererGlyphFormat format = line.formats.at(linePos);
+
+        if (format != ErrorGlyphFormat && format != PreeditGlyphFormat)
+        {
+            linePos++;
+            continue;
+        }
+
+        int end = linePos;
+
+        while (end < line.formats.length() && line.formats.at(end) == format)
+        {
+            end++;
+        }
+
+        const qreal x1 = line.cursorX.at(linePos);
+        const qreal x2 = line.cursorX.at(end);
+
+        if (format == ErrorGlyphFormat)
+        {
+            line.underlines.append(QRectF(qMin(x1, x2), line.baseline + line.underlinePos, qAbs(x2 - x1), line.underlineWidth));
+        }
+        else
+        {
+            line.backgrounds.append(QRectF(qMin(x1, x2), line.y, qAbs(x2 - x1), line.textHeight));
+        }
+
+        linePos = end;
+    }
+
+    d->decorationsDirty = true;
+}
+
+void LessonRenderer::updateCursorRectangle()
+{
+    if (!m_trainingLineCore || m_lineCount == 0 || m_currentLine >= m_lineCount || m_currentLine + 1 >= d->lines.length())
+        return;
+
+    const LessonRendererLine& line = d->lines.at(m_currentLine + 1);
+    const int relCursorPos = qMin(m_trainingLineCore->actualLine().length() + m_trainingLineCore->preeditString().length(), line.cursorX.length() - 1);
+    const qreal devicePixelRatio = d->devicePixelRatio;
+
+    m_cursorRectangle = QRectF(
+                line.cursorX.at(relCursorPos) / devicePixelRatio,
+                line.y / devicePixelRatio,
+                1,
+                line.textHeight / devicePixelRatio);
+
+    emit cursorRectangleChanged();
+}
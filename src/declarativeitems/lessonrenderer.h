@@ -0,0 +1,99 @@
+/*
+ *  Copyright 2026  Sebastian Gottfried <sebastian.gottfried@posteo.de>
+ *
+ *  This program is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU General Public License as
+ *  published by the Free Software Foundation; either version 2 of
+ *  the License, or (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef LESSONRENDERER_H
+#define LESSONRENDERER_H
+
+#include <QQuickItem>
+
+#include <QPointer>
+
+#include "core/lessontextindex.h"
+
+class QFont;
+
+class Lesson;
+class TrainingLineCore;
+struct LessonRendererLine;
+struct LessonRendererPrivate;
+
+/**
+ * Scene graph based alternative to LessonPainter with the same interface.
+ *
+ * The glyphs of the lesson are rasterized once into a texture atlas and
+ * drawn as textured quads, one geometry node per line. Typing only changes
+ * the vertex colors of the training line and the geometry of the error
+ * underlines and the preedit background, so there is no texture upload per
+ * key press unless a glyph appears for the first time.
+ *
+ * Needs the OpenGL scene graph backend.
+ */
+class LessonRenderer : public QQuickItem
+{
+    Q_OBJECT
+    Q_PROPERTY(Lesson* lesson READ lesson WRITE setLesson NOTIFY lessonChanged)
+    Q_PROPERTY(qreal maximumWidth READ maximumWidth WRITE setMaximumWidth NOTIFY maximumWidthChanged)
+    Q_PROPERTY(qreal maximumHeight READ maximumHeight WRITE setMaximumHeight NOTIFY maximumHeightChanged)
+    Q_PROPERTY(TrainingLineCore* trainingLineCore READ trainingLineCore WRITE setTrainingLineCore NOTIFY trainingLineCoreChanged)
+    Q_PROPERTY(QRectF cursorRectangle READ cursorRectangle NOTIFY cursorRectangleChanged)
+public:
+    explicit LessonRenderer(QQuickItem* parent = 0);
+    ~LessonRenderer();
+    Lesson* lesson() const;
+    void setLesson(Lesson* lesson);
+    qreal maximumWidth() const;
+    void setMaximumWidth(qreal maximumWidth);
+    qreal maximumHeight() const;
+    void setMaximumHeight(qreal maximumHeight);
+    TrainingLineCore* trainingLineCore() const;
+    void setTrainingLineCore(TrainingLineCore* trainingLineCore);
+    QRectF cursorRectangle() const;
+public slots:
+    void reset();
+signals:
+    void lessonChanged();
+    void maximumWidthChanged();
+    void maximumHeightChanged();
+    void trainingLineCoreChanged();
+    void cursorRectangleChanged();
+    void done();
+protected:
+    QSGNode* updatePaintNode(QSGNode* oldNode, UpdatePaintNodeData* data) override;
+    void itemChange(ItemChange change, const ItemChangeData& value) override;
+private slots:
+    void updateLayout();
+    void resetTrainingStatus();
+    void updateTrainingStatus();
+    void advanceToNextTrainingLine();
+private:
+    QSizeF layoutLines(qreal scale, bool withGlyphs);
+    void layoutLine(LessonRendererLine& line, const QFont& font, qreal y, bool withGlyphs);
+    void updateDecorations(LessonRendererLine& line);
+    void updateCursorRectangle();
+    LessonRendererPrivate* d;
+    QPointer<Lesson> m_lesson;
+    LessonTextIndex m_lines;
+    int m_lineCount;
+    qreal m_textScale;
+    qreal m_maximumWidth;
+    qreal m_maximumHeight;
+    TrainingLineCore* m_trainingLineCore;
+    int m_currentLine;
+    QRectF m_cursorRectangle;
+};
+
+#endif // LESSONRENDERER_H
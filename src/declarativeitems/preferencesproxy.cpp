@@ -18,87 +18,120 @@
 #include "preferencesproxy.h"
 
 #include "preferences.h"
+#include "preferencescache.h"
 
 PreferencesProxy::PreferencesProxy(QObject* parent):
     QObject(parent)
 
 {
-    connect(Preferences::self(), &KCoreConfigSkeleton::configChanged, this, &PreferencesProxy::configChanged);
+    connect(PreferencesCache::instance(), &PreferencesCache::snapshotChanged, this, &PreferencesProxy::configChanged);
 }
 
 bool PreferencesProxy::showKeyboard() const
 {
-    return Preferences::showKeyboard();
+    return PreferencesCache::snapshot().showKeyboard;
 }
 
 void PreferencesProxy::setShowKeyboard(bool showKeyboard)
 {
     Preferences::setShowKeyboard(showKeyboard);
+    PreferencesCache::instance()->refresh();
 }
 
 bool PreferencesProxy::showStatistics() const
 {
-    return Preferences::showStatistics();
+    return PreferencesCache::snapshot().showStatistics;
 }
 
 void PreferencesProxy::setShowStatistics(bool showStatistics)
 {
     Preferences::setShowStatistics(showStatistics);
+    PreferencesCache::instance()->refresh();
 }
 
 bool PreferencesProxy::nextLineWithSpace() const
 {
-    return Preferences::nextLineWithSpace();
+    return PreferencesCache::snapshot().nextLineWithSpace;
 }
 
 void PreferencesProxy::setNextLineWithSpace(bool nextLineWithSpace)
 {
     Preferences::setNextLineWithSpace(nextLineWithSpace);
+    PreferencesCache::instance()->refresh();
 }
 
 bool PreferencesProxy::nextLineWithReturn() const
 {
-    return Preferences::nextLineWithReturn();
+    return PreferencesCache::snapshot().nextLineWithReturn;
 }
 
 void PreferencesProxy::setNextLineWithReturn(bool nextLineWithReturn)
 {
     Preferences::setNextLineWithReturn(nextLineWithReturn);
+    PreferencesCache::instance()->refresh();
 }
 
 int PreferencesProxy::requiredStrokesPerMinute() const
 {
-    return Preferences::requiredStrokesPerMinute();
+    return PreferencesCache::snapshot().requiredStrokesPerMinute;
 }
 
 void PreferencesProxy::setRequiredStrokesPerMinute(int strokesPerMinute)
 {
     Preferences::setRequiredStrokesPerMinute(strokesPerMinute);
+    PreferencesCache::instance()->refresh();
 }
 
 double PreferencesProxy::requiredAccuracy() const
 {
-    return Preferences::requiredAccuracy();
+    return PreferencesCache::snapshot().requiredAccuracy;
 }
 
 void PreferencesProxy::setRequiredAccuracy(double accuracy)
 {
     Preferences::setRequiredStrokesPerMinute(accuracy);
+    PreferencesCache::instance()->refresh();
 }
 
 int PreferencesProxy::lastUsedProfileId() const
 {
-    return Preferences::lastUsedProfileId();
+    return PreferencesCache::snapshot().lastUsedProfileId;
 }
 
 void PreferencesProxy::setLastUsedProfileId(int profileId)
 {
     Preferences::setLastUsedProfileId(profileId);
+    PreferencesCache::instance()->refresh();
+}
+
+bool PreferencesProxy::sceneGraphLessonRenderer() const
+{
+    return PreferencesCache::snapshot().sceneGraphLessonRenderer;
+}
+
+void PreferencesProxy::setSceneGraphLessonRenderer(bool sceneGraphLessonRenderer)
+{
+    Preferences::setSceneGraphLessonRenderer(sceneGraphLessonRenderer);
+    PreferencesCache::instance()->refresh();
+}
+
+bool PreferencesProxy::sceneGraphKeyboardRenderer() const
+{
+    return PreferencesCache::snapshot().sceneGraphKeyboardRenderer;
+}
+
+void PreferencesProxy::setSceneGraphKeyboardRenderer(bool sceneGraphKeyboardRenderer)
+{
+    Preferences::setSceneGraphKeyboardRenderer(sceneGraphKeyboardRenderer);
+    PreferencesCache::instance()->refresh();
 }
 
 QColor PreferencesProxy::fingerColor(int index)
 {
-    return Preferences::fingerColor(index);
+    if (index < 0 || index >= PreferencesSnapshot::fingerColorCount)
+        return QColor();
+
+    return PreferencesCache::snapshot().fingerColors[index];
 }
 
 void PreferencesProxy::writeConfig()
@@ -32,6 +32,8 @@ class PreferencesProxy : public QObject
     Q_PROPERTY(int requiredStrokesPerMinute READ requiredStrokesPerMinute WRITE setRequiredStrokesPerMinute NOTIFY configChanged)
     Q_PROPERTY(double requiredAccuracy READ requiredAccuracy WRITE setRequiredAccuracy NOTIFY configChanged)
     Q_PROPERTY(int lastUsedProfileId READ lastUsedProfileId WRITE setLastUsedProfileId NOTIFY configChanged)
+    Q_PROPERTY(bool sceneGraphLessonRenderer READ sceneGraphLessonRenderer WRITE setSceneGraphLessonRenderer NOTIFY configChanged)
+    Q_PROPERTY(bool sceneGraphKeyboardRenderer READ sceneGraphKeyboardRenderer WRITE setSceneGraphKeyboardRenderer NOTIFY configChanged)
 
 public:
     explicit PreferencesProxy(QObject* parent = 0);
@@ -49,6 +51,10 @@ public:
     void setRequiredAccuracy(double accuracy);
     int lastUsedProfileId() const;
     void setLastUsedProfileId(int profileId);
+    bool sceneGraphLessonRenderer() const;
+    void setSceneGraphLessonRenderer(bool sceneGraphLessonRenderer);
+    bool sceneGraphKeyboardRenderer() const;
+    void setSceneGraphKeyboardRenderer(bool sceneGraphKeyboardRenderer);
     Q_INVOKABLE QColor fingerColor(int index);
     Q_INVOKABLE void writeConfig();
 
@@ -21,12 +21,13 @@
 #include <QTextBoundaryFinder>
 
 #include "core/trainingstats.h"
-#include "preferences.h"
+#include "preferencescache.h"
 
 TrainingLineCore::TrainingLineCore(QQuickItem* parent) :
     QQuickItem(parent),
     m_active(false),
     m_trainingStats(0),
+    m_firstMismatch(-1),
     m_hintKey(-1),
     m_keyHintOccurrenceCount(0)
 {
@@ -86,6 +87,7 @@ void TrainingLineCore::setReferenceLine(const QString& referenceLine)
     {
         m_referenceLine = referenceLine;
         m_actualLine = QLatin1String("");
+        m_firstMismatch = -1;
         clearKeyHint();
         emit referenceLineChanged();
         emit actualLineChanged();
@@ -104,10 +106,19 @@ QString TrainingLineCore::preeditString() const
 
 bool TrainingLineCore::isCorrect() const
 {
-    if (!Preferences::enforceTypingErrorCorrection())
+    if (!PreferencesCache::snapshot().enforceTypingErrorCorrection)
         return true;
 
-    return m_actualLine == m_referenceLine.left(m_actualLine.length());
+    return m_firstMismatch == -1;
+}
+
+/**
+ * Position of the first character in the actual line differing from the
+ * reference line or -1 if the actual line is a prefix of the reference line.
+ */
+int TrainingLineCore::firstMismatch() const
+{
+    return m_firstMismatch;
 }
 
 QString TrainingLineCore::nextCharacter() const
@@ -131,6 +142,7 @@ void TrainingLineCore::reset()
 {
     m_referenceLine = QLatin1String("");
     m_actualLine = QLatin1String("");
+    m_firstMismatch = -1;
     clearKeyHint();
     emit referenceLineChanged();
     emit actualLineChanged();
@@ -148,7 +160,7 @@ void TrainingLineCore::keyPressEvent(QKeyEvent* event)
 
     if (isCorrect() && m_referenceLine.length() == m_actualLine.length())
     {
-        if (Preferences::nextLineWithReturn())
+        if (PreferencesCache::snapshot().nextLineWithReturn)
         {
             if (event->key() == Qt::Key_Return)
             {
@@ -163,7 +175,7 @@ void TrainingLineCore::keyPressEvent(QKeyEvent* event)
                 giveKeyHint(Qt::Key_Return);
             }
         }
-        else if (Preferences::nextLineWithSpace())
+        else if (PreferencesCache::snapshot().nextLineWithSpace)
         {
             if (event->key() == Qt::Key_Space)
             {
@@ -279,24 +291,28 @@ QVariant TrainingLineCore::inputMethodQuery(Qt::InputMethodQuery query) const
 
 void TrainingLineCore::add(const QString& text)
 {
-    const int maxLength = m_referenceLine.length();
     const int actualLength = m_actualLine.length();
-
-    const QString newText = text.left(maxLength - actualLength);
+    const int newLength = qMin(text.length(), m_referenceLine.length() - actualLength);
+    const bool enforceTypingErrorCorrection = PreferencesCache::snapshot().enforceTypingErrorCorrection;
     bool correct = isCorrect();
 
-    for (int i = 0; i < newText.length(); i++)
+    for (int i = 0; i < newLength; i++)
     {
-        const QString character(newText.at(i));
-        const QString referenceCharacter(m_referenceLine.at(actualLength + i));
+        const QChar character = text.at(i);
+        const QChar referenceCharacter = m_referenceLine.at(actualLength + i);
         const bool characterIsCorrect = character == referenceCharacter;
 
+        if (!characterIsCorrect && m_firstMismatch == -1)
+        {
+            m_firstMismatch = actualLength + i;
+        }
+
         if (m_trainingStats)
         {
-            m_trainingStats->logCharacter(referenceCharacter, characterIsCorrect? TrainingStats::CorrectCharacter: TrainingStats::IncorrectCharacter);
+            m_trainingStats->recordKeystroke(referenceCharacter, character, characterIsCorrect? TrainingStats::CorrectCharacter: TrainingStats::IncorrectCharacter);
         }
 
-        correct = correct && (!Preferences::enforceTypingErrorCorrection() || characterIsCorrect);
+        correct = correct && (!enforceTypingErrorCorrection || characterIsCorrect);
 
         if (correct)
         {
@@ -308,7 +324,7 @@ void TrainingLineCore::add(const QString& text)
         }
     }
 
-    m_actualLine += text.leftRef(maxLength - actualLength);
+    m_actualLine += text.leftRef(newLength);
     emit actualLineChanged();
 }
 
@@ -316,9 +332,10 @@ void TrainingLineCore::backspace()
 {
     const int actualLength = m_actualLine.length();
 
-    if (actualLength > 0 && Preferences::enforceTypingErrorCorrection())
+    if (actualLength > 0 && PreferencesCache::snapshot().enforceTypingErrorCorrection)
     {
-        m_actualLine = m_actualLine.left(actualLength - 1);
+        m_actualLine.chop(1);
+        truncateFirstMismatch();
         emit actualLineChanged();
 
         if (isCorrect())
@@ -332,14 +349,15 @@ void TrainingLineCore::deleteStartOfWord()
 {
     const int actualLength = m_actualLine.length();
 
-    if (actualLength > 0 && Preferences::enforceTypingErrorCorrection())
+    if (actualLength > 0 && PreferencesCache::snapshot().enforceTypingErrorCorrection)
     {
         QTextBoundaryFinder finder(QTextBoundaryFinder::Word, m_actualLine);
 
         finder.setPosition(actualLength);
         finder.toPreviousBoundary();
 
-        m_actualLine = m_actualLine.left(finder.position());
+        m_actualLine.truncate(finder.position());
+        truncateFirstMismatch();
         emit actualLineChanged();
     }
 }
@@ -347,9 +365,18 @@ void TrainingLineCore::deleteStartOfWord()
 void TrainingLineCore::clearActualLine()
 {
     m_actualLine = QLatin1String("");
+    m_firstMismatch = -1;
     emit actualLineChanged();
 }
 
+void TrainingLineCore::truncateFirstMismatch()
+{
+    if (m_firstMismatch >= m_actualLine.length())
+    {
+        m_firstMismatch = -1;
+    }
+}
+
 void TrainingLineCore::giveKeyHint(int key)
 {
     if (key == m_hintKey)
@@ -49,6 +49,7 @@ public:
     QString actualLine() const;
     QString preeditString() const;
     bool isCorrect() const;
+    int firstMismatch() const;
     QString nextCharacter() const;
     int hintKey() const;
 public slots:
@@ -71,6 +72,7 @@ private:
     void backspace();
     void deleteStartOfWord();
     void clearActualLine();
+    void truncateFirstMismatch();
     void giveKeyHint(int key);
     void clearKeyHint();
     bool m_active;
@@ -78,6 +80,7 @@ private:
     QString m_referenceLine;
     QString m_actualLine;
     QString m_preeditString;
+    int m_firstMismatch;
     int m_hintKey;
     int m_keyHintOccurrenceCount;
     QPointer<QQuickItem> m_cursorItem;
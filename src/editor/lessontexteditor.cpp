@@ -24,6 +24,7 @@
 #include <KLocalizedString>
 #include <KMessageBox>
 
+#include "core/textkernels.h"
 #include "editor/lessontexthighlighter.h"
 
 LessonTextEditor::LessonTextEditor(QWidget* parent) :
@@ -112,9 +113,7 @@ void LessonTextEditor::reformatText()
 
     QString text = doPartialReplace? cursor.selectedText(): m_lessonTextEdit->toPlainText();
 
-    text.replace('\r', QLatin1String(" "));
-    text.replace('\n', QLatin1String(" "));
-    text.replace(QString::fromUtf8("\u2029"), QLatin1String(" "));
+    TextKernels::replaceLineBreaks(text);
 
     const QStringList tokens(text.split(' '));
     QStringList lines;
@@ -19,6 +19,8 @@
 
 #include <KColorScheme>
 
+#include "core/textkernels.h"
+
 LessonTextHighlighter::LessonTextHighlighter(QObject* parent):
     QSyntaxHighlighter(parent),
     m_maximumLineLength(60)
@@ -42,6 +44,9 @@ void LessonTextHighlighter::setAllowedCharacters(const QString& characters)
     if (characters != m_allowedCharacters)
     {
         m_allowedCharacters = characters;
+        m_allowedCharacterSet = CharacterSet(characters);
+        // spaces are always allowed
+        m_allowedCharacterSet.insert(uint(' '));
         rehighlight();
     };
 }
@@ -62,8 +67,6 @@ void LessonTextHighlighter::setMaximumLineLength(int length)
 
 void LessonTextHighlighter::highlightBlock(const QString& text)
 {
-    const QLatin1Char space(32);
-
     if (text.length() > m_maximumLineLength)
     {
         setFormat(m_maximumLineLength, text.length() - m_maximumLineLength, m_overLongLineFormat);
@@ -72,13 +75,17 @@ void LessonTextHighlighter::highlightBlock(const QString& text)
     if (m_allowedCharacters.isNull())
         return;
 
-    for (int i = 0; i < text.length(); i++)
+    int i = 0;
+
+    while (true)
     {
-        const QChar c = text.at(i);
+        i += TextKernels::indexOfMissing(text.constData() + i, text.length() - i, m_allowedCharacterSet);
+
+        if (i >= text.length())
+            break;
 
-        if (c != space && !m_allowedCharacters.contains(c))
-        {
-            setFormat(i, 1, m_invalidCharFormat);
-        }
+        const int length = QChar::requiresSurrogates(CharacterSet::codePointAt(text, i))? 2: 1;
+        setFormat(i, length, m_invalidCharFormat);
+        i += length;
     }
 }
@@ -22,6 +22,8 @@
 
 #include <QTextCharFormat>
 
+#include "core/characterset.h"
+
 class LessonTextHighlighter : public QSyntaxHighlighter
 {
     Q_OBJECT
@@ -38,6 +40,7 @@ protected:
 private:
     int m_maximumLineLength;
     QString m_allowedCharacters;
+    CharacterSet m_allowedCharacterSet;
     QTextCharFormat m_overLongLineFormat;
     QTextCharFormat m_invalidCharFormat;
 };
@@ -57,7 +57,12 @@ KTouchContext::KTouchContext(KMainWindow* mainWindow, QQuickView* view, QObject
 #ifdef KTOUCH_BUILD_WITH_X11
     m_XEventNotifier = new XEventNotifier();
     m_XEventNotifier->start();
-    connect(m_XEventNotifier, &XEventNotifier::layoutChanged, this, &KTouchContext::keyboardLayoutNameChanged);
+    connect(m_XEventNotifier, &XEventNotifier::layoutChanged, this, &KTouchContext::updateKeyboardLayoutName);
+    connect(m_XEventNotifier, &XEventNotifier::layoutMapChanged, this, &KTouchContext::updateKeyboardLayouts);
+    m_keyboardLayouts = X11Helper::getLayoutsList();
+    m_keyboardLayoutName = X11Helper::getCurrentLayout(m_keyboardLayouts).toString();
+#else
+    m_keyboardLayoutName = QStringLiteral("unknown");
 #endif
     init();
 }
@@ -71,11 +76,28 @@ KTouchContext::~KTouchContext()
 }
 
 QString KTouchContext::keyboardLayoutName() const
+{
+    return m_keyboardLayoutName;
+}
+
+void KTouchContext::updateKeyboardLayoutName()
 {
 #ifdef KTOUCH_BUILD_WITH_X11
-    return X11Helper::getCurrentLayout().toString();
-#else
-    return "unknown";
+    const QString keyboardLayoutName = X11Helper::getCurrentLayout(m_keyboardLayouts).toString();
+
+    if (keyboardLayoutName != m_keyboardLayoutName)
+    {
+        m_keyboardLayoutName = keyboardLayoutName;
+        emit keyboardLayoutNameChanged();
+    }
+#endif
+}
+
+void KTouchContext::updateKeyboardLayouts()
+{
+#ifdef KTOUCH_BUILD_WITH_X11
+    m_keyboardLayouts = X11Helper::getLayoutsList();
+    updateKeyboardLayoutName();
 #endif
 }
 
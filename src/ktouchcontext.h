@@ -18,6 +18,7 @@
 #ifndef KTOUCHCONTEXT_H
 #define KTOUCHCONTEXT_H
 
+#include <QList>
 #include <QObject>
 
 class QMenu;
@@ -31,6 +32,7 @@ class KeyboardLayout;
 class KeyboardLayoutMenu;
 class Lesson;
 class XEventNotifier;
+struct LayoutUnit;
 
 class KTouchContext : public QObject
 {
@@ -54,6 +56,8 @@ private slots:
     void showConfigDialog();
     void configureShortcuts();
     void setFullscreen(bool fullscreen);
+    void updateKeyboardLayoutName();
+    void updateKeyboardLayouts();
 signals:
     void keyboardLayoutNameChanged();
 private:
@@ -65,7 +69,10 @@ private:
     QQuickView* m_view;
 #ifdef KTOUCH_BUILD_WITH_X11
     XEventNotifier* m_XEventNotifier;
+    // only refreshed on layout map changes, each query is a server round trip
+    QList<LayoutUnit> m_keyboardLayouts;
 #endif
+    QString m_keyboardLayoutName;
 };
 
 #endif // KTOUCHCONTEXT_H
@@ -73,10 +73,14 @@ int main(int argc, char **argv)
 
     parser.addOption({{"I", "import-path"}, i18n("Prepend the path to the list of QML import paths"), QStringLiteral("path")});
 
+    parser.addOption(QCommandLineOption(QStringLiteral("startup-trace"), i18n("Write the timings of the startup stages as Chrome trace to the file"), QStringLiteral("file")));
+
     parser.process(app);
 
     about.processCommandLine(&parser);
 
+    app.startLoading(parser.value(QStringLiteral("startup-trace")));
+
     if (parser.isSet(QStringLiteral("import-path")))
     {
         foreach (const QString& path, parser.values("import-path"))
@@ -19,6 +19,7 @@
 
 #include <QVariant>
 #include <QStandardPaths>
+#include <QQmlComponent>
 #include <QQmlContext>
 #include <QQmlError>
 #include <QMessageBox>
@@ -28,11 +29,16 @@
 
 #include "application.h"
 #include "ktouchcontext.h"
+#include "startuptrace.h"
+
+const QUrl mainQmlUrl(QStringLiteral("qrc:/ktouch/qml/main.qml"));
 
 MainWindow::MainWindow(QWidget* parent):
     KMainWindow(parent),
     m_view(new QQuickView()),
-    m_context(new KTouchContext(this, m_view, this))
+    m_context(new KTouchContext(this, m_view, this)),
+    m_mainComponent(0),
+    m_compileBegin(0)
 {
     init();
 }
@@ -55,7 +61,51 @@ void MainWindow::init()
     m_view->connect(m_view, &QQuickView::statusChanged, this, &MainWindow::onViewStatusChanged);
     m_view->rootContext()->setContextProperty(QStringLiteral("ktouch"), m_context);
     m_view->setResizeMode(QQuickView::SizeRootObjectToView);
-    m_view->setSource(QUrl(QStringLiteral("qrc:/ktouch/qml/main.qml")));
+
+    // compile the QML code on the engine's loader thread while the data
+    // index is still being loaded; setting the source of the view afterwards
+    // hits the engine's type cache
+    m_compileBegin = StartupTrace::now();
+    m_mainComponent = new QQmlComponent(m_view->engine(), mainQmlUrl, QQmlComponent::Asynchronous, this);
+
+    if (m_mainComponent->isLoading())
+    {
+        connect(m_mainComponent, &QQmlComponent::statusChanged, this, &MainWindow::onMainComponentStatusChanged);
+    }
+    else
+    {
+        onMainComponentStatusChanged();
+    }
+}
+
+void MainWindow::onMainComponentStatusChanged()
+{
+    if (m_mainComponent->isLoading())
+        return;
+
+    StartupTrace::record(QStringLiteral("QML compilation"), m_compileBegin, StartupTrace::now());
+
+    m_mainComponent->deleteLater();
+    m_mainComponent = 0;
+
+    // wait for the data index before the QML code starts to access it
+    Application::dataIndex();
+
+    m_frameSwappedConnection = connect(m_view, &QQuickWindow::frameSwapped, this, &MainWindow::onFrameSwapped);
+
+    StartupTrace::Span span(QStringLiteral("QML object creation"));
+    m_view->setSource(mainQmlUrl);
+}
+
+void MainWindow::onFrameSwapped()
+{
+    // the signal is queued from the render thread, so more than one
+    // invocation might be pending already
+    if (!m_frameSwappedConnection)
+        return;
+
+    disconnect(m_frameSwappedConnection);
+    Application::reportFirstFrame();
 }
 
 void MainWindow::onViewStatusChanged(QQuickView::Status status)
@@ -23,6 +23,7 @@
 #include <QWeakPointer>
 #include <QQuickView>
 
+class QQmlComponent;
 class KTouchContext;
 
 #ifdef KTOUCH_BUILD_WITH_X11
@@ -37,9 +38,14 @@ public:
     ~MainWindow();
 private:
     void init();
+    void onMainComponentStatusChanged();
     void onViewStatusChanged(QQuickView::Status status);
+    void onFrameSwapped();
     QQuickView* m_view;
     KTouchContext* m_context;
+    QQmlComponent* m_mainComponent;
+    qint64 m_compileBegin;
+    QMetaObject::Connection m_frameSwappedConnection;
 };
 
 #endif // MAINWINDOW_H
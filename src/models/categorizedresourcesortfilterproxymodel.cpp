@@ -122,6 +122,10 @@ bool CategorizedResourceSortFilterProxyModel::filterAcceptsRow(int source_row, c
     if ((m_resourceTypeFilter & resourceType) == 0)
         return false;
 
+    // resources which failed the validation while building the index
+    if (!sourceModel()->data(index, ResourceModel::IsValidRole).toBool())
+        return false;
+
     if (m_keyboardLayoutNameFilter.isEmpty())
         return true;
 
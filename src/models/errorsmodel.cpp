@@ -19,7 +19,7 @@
 
 #include "core/trainingstats.h"
 
-bool lessThan(const QPair<QString,int>& left, const QPair<QString,int>& right)
+bool lessThan(const QPair<QChar,int>& left, const QPair<QChar,int>& right)
 {
     return left.second > right.second;
 }
@@ -57,6 +57,7 @@ void ErrorsModel::setTrainingStats(TrainingStats* trainingStats)
         if (m_trainingStats)
         {
             connect(m_trainingStats, &TrainingStats::errorsChanged, this, &ErrorsModel::buildErrorList);
+            connect(m_trainingStats, &TrainingStats::characterErrorsChanged, this, &ErrorsModel::updateCharacter);
         }
 
         buildErrorList();
@@ -77,7 +78,7 @@ QVariant ErrorsModel::data(const QModelIndex& index, int role) const
     case Qt::DisplayRole:
         return QVariant(m_errors.at(index.row()).second);
     case Qt::ToolTipRole:
-        return QVariant(m_errors.at(index.row()).first);
+        return QVariant(QString(m_errors.at(index.row()).first));
     default:
         return QVariant();
     }
@@ -95,10 +96,7 @@ int ErrorsModel::rowCount(const QModelIndex& parent) const
     if (parent.isValid())
         return 0;
 
-    if (!m_trainingStats)
-        return 0;
-
-    return m_trainingStats->errorMap().count();
+    return m_errors.count();
 }
 
 QVariant ErrorsModel::headerData(int section, Qt::Orientation orientation, int role) const
@@ -130,12 +128,12 @@ void ErrorsModel::buildErrorList()
         return;
     }
 
-    QMapIterator<QString, int> errorIterator(m_trainingStats->errorMap());
+    const CharacterErrorMap& errorMap = m_trainingStats->errorMap();
 
-    while(errorIterator.hasNext())
+    for (int i = 0; i < errorMap.characterCount(); i++)
     {
-        errorIterator.next();
-        m_errors.append(QPair<QString,int>(errorIterator.key(), errorIterator.value()));
+        const QChar character = errorMap.character(i);
+        m_errors.append(QPair<QChar,int>(character, errorMap.errorCount(character)));
     }
 
     std::sort(m_errors.begin(), m_errors.end(), lessThan);
@@ -145,9 +143,65 @@ void ErrorsModel::buildErrorList()
     endResetModel();
 }
 
+void ErrorsModel::updateCharacter(QChar character)
+{
+    const int errorCount = m_trainingStats->errorMap().errorCount(character);
+    int row = rowOf(character);
+
+    if (row == -1)
+    {
+        // new characters have the lowest count seen so far, or tie with it
+        row = m_errors.count();
+
+        while (row > 0 && m_errors.at(row - 1).second < errorCount)
+            row--;
+
+        beginInsertRows(QModelIndex(), row, row);
+        m_errors.insert(row, QPair<QChar,int>(character, errorCount));
+        endInsertRows();
+    }
+    else
+    {
+        m_errors[row].second = errorCount;
+
+        int targetRow = row;
+
+        while (targetRow > 0 && m_errors.at(targetRow - 1).second < errorCount)
+            targetRow--;
+
+        if (targetRow != row)
+        {
+            beginMoveRows(QModelIndex(), row, row, QModelIndex(), targetRow);
+            m_errors.move(row, targetRow);
+            endMoveRows();
+        }
+
+        const QModelIndex changedIndex = index(targetRow, 0);
+        emit dataChanged(changedIndex, changedIndex);
+        row = targetRow;
+    }
+
+    if (row == 0)
+    {
+        emit maximumErrorCountChanged();
+    }
+}
+
+int ErrorsModel::rowOf(QChar character) const
+{
+    // there are rarely more than a few dozen characters with errors
+    for (int row = 0; row < m_errors.count(); row++)
+    {
+        if (m_errors.at(row).first == character)
+            return row;
+    }
+
+    return -1;
+}
+
 QString ErrorsModel::character(int row) const
 {
-    return m_errors.at(row).first;
+    return QString(m_errors.at(row).first);
 }
 
 int ErrorsModel::errors(int row) const
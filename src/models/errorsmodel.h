@@ -19,6 +19,7 @@
 #define ERRORSMODEL_H
 
 #include <QAbstractTableModel>
+#include <QVector>
 
 class TrainingStats;
 
@@ -43,9 +44,11 @@ signals:
     void maximumErrorCountChanged();
 private slots:
     void buildErrorList();
+    void updateCharacter(QChar character);
 private:
+    int rowOf(QChar character) const;
     TrainingStats* m_trainingStats;
-    QList<QPair<QString, int> > m_errors;
+    QVector<QPair<QChar, int> > m_errors;
 };
 
 #endif // ERRORSMODEL_H
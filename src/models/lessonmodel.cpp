@@ -23,6 +23,22 @@
 #include <core/course.h>
 #include <core/lesson.h>
 
+namespace
+{
+    // custom lessons can be thousands of lines long
+    const int maxToolTipLines = 10;
+
+    QString textPreview(const Lesson* lesson)
+    {
+        const LessonTextIndex& textIndex = lesson->textIndex();
+
+        if (textIndex.lineCount() <= maxToolTipLines)
+            return textIndex.text();
+
+        return textIndex.text().left(textIndex.lineOffset(maxToolTipLines) - 1) + QChar(0x2026);
+    }
+}
+
 LessonModel::LessonModel(QObject* parent) :
     QAbstractListModel(parent),
     m_course(0)
@@ -53,6 +69,8 @@ void LessonModel::setCourse(Course* course)
             connect(m_course, &Course::lessonAdded, this, &LessonModel::onLessonAdded);
             connect(m_course, &Course::lessonsAboutToBeRemoved, this, &LessonModel::onLessonsAboutToBeRemoved);
             connect(m_course, &Course::lessonsRemoved, this, &LessonModel::onLessonsRemoved);
+            connect(m_course, &Course::lessonsAboutToBeReset, this, &LessonModel::onLessonsAboutToBeReset);
+            connect(m_course, &Course::lessonsReset, this, &LessonModel::onLessonsReset);
         }
 
         endResetModel();
@@ -77,7 +95,7 @@ QVariant LessonModel::data(const QModelIndex& index, int role) const
             return !lesson->title().isEmpty()?
                 QVariant(lesson->title()): QVariant(i18n("<No title>"));
         case Qt::ToolTipRole:
-            return QVariant(i18n("<p>New characters: %1</p><p>%2</p>", lesson->newCharacters(), lesson->text()));
+            return QVariant(i18n("<p>New characters: %1</p><p>%2</p>", lesson->newCharacters(), textPreview(lesson)));
         case LessonModel::DataRole:
             return QVariant::fromValue<QObject*>(lesson);
         default:
@@ -120,6 +138,17 @@ void LessonModel::onLessonsRemoved()
     endRemoveRows();
 }
 
+void LessonModel::onLessonsAboutToBeReset()
+{
+    beginResetModel();
+}
+
+void LessonModel::onLessonsReset()
+{
+    updateMappings();
+    endResetModel();
+}
+
 void LessonModel::emitLessonChanged(int row)
 {
     emit lessonChanged(row);
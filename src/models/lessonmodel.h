@@ -49,6 +49,8 @@ private slots:
     void onLessonAdded();
     void onLessonsAboutToBeRemoved(int first, int last);
     void onLessonsRemoved();
+    void onLessonsAboutToBeReset();
+    void onLessonsReset();
     void emitLessonChanged(int row);
 
 private:
@@ -124,6 +124,7 @@ QHash<int, QByteArray> ResourceModel::roleNames() const
     names.insert(ResourceModel::KeyboardLayoutNameRole, "keyboardLayoutName");
     names.insert(ResourceModel::PathRole, "path");
     names.insert(ResourceModel::DataRole, "dataRole");
+    names.insert(ResourceModel::IsValidRole, "isValid");
     return names;
 }
 
@@ -204,6 +205,8 @@ QVariant ResourceModel::courseData(int row, int role) const
         return QVariant(row);
     case ResourceModel::SourceRole:
         return QVariant(m_dataIndex->course(row)->source());
+    case ResourceModel::IsValidRole:
+        return QVariant(m_dataIndex->course(row)->isValid());
     default:
         return QVariant();
     }
@@ -238,6 +241,8 @@ QVariant ResourceModel::keyboardLayoutData(int row, int role) const
         return QVariant(row);
     case ResourceModel::SourceRole:
         return QVariant(m_dataIndex->keyboardLayout(row)->source());
+    case ResourceModel::IsValidRole:
+        return QVariant(m_dataIndex->keyboardLayout(row)->isValid());
     default:
         return QVariant();
     }
@@ -250,11 +255,13 @@ void ResourceModel::connectToCourse(DataIndexCourse* course, int index)
     disconnect(course, &DataIndexCourse::keyboardLayoutNameChanged, this, nullptr);
     disconnect(course, &DataIndexCourse::pathChanged, this, nullptr);
     disconnect(course, &DataIndexCourse::sourceChanged, this, nullptr);
+    disconnect(course, &DataIndexCourse::isValidChanged, this, nullptr);
     connect(course, &DataIndexCourse::titleChanged, this, [=] { emitDataChanged(index); });
     connect(course, &DataIndexCourse::descriptionChanged, this, [=] { emitDataChanged(index); });
     connect(course, &DataIndexCourse::keyboardLayoutNameChanged, this, [=] { emitDataChanged(index); });
     connect(course, &DataIndexCourse::pathChanged, this, [=] { emitDataChanged(index); });
     connect(course, &DataIndexCourse::sourceChanged, this, [=] { emitDataChanged(index); });
+    connect(course, &DataIndexCourse::isValidChanged, this, [=] { emitDataChanged(index); });
 }
 
 void ResourceModel::connectToKeyboardLayout(DataIndexKeyboardLayout *keyboardLayout, int index)
@@ -263,10 +270,12 @@ void ResourceModel::connectToKeyboardLayout(DataIndexKeyboardLayout *keyboardLay
     disconnect(keyboardLayout, &DataIndexKeyboardLayout::nameChanged, this, nullptr);
     disconnect(keyboardLayout, &DataIndexKeyboardLayout::pathChanged, this, nullptr);
     disconnect(keyboardLayout, &DataIndexKeyboardLayout::sourceChanged, this, nullptr);
+    disconnect(keyboardLayout, &DataIndexKeyboardLayout::isValidChanged, this, nullptr);
     connect(keyboardLayout, &DataIndexKeyboardLayout::titleChanged, this, [=] { emitDataChanged(index); });
     connect(keyboardLayout, &DataIndexKeyboardLayout::nameChanged, this, [=] { emitDataChanged(index); });
     connect(keyboardLayout, &DataIndexKeyboardLayout::pathChanged, this, [=] { emitDataChanged(index); });
     connect(keyboardLayout, &DataIndexKeyboardLayout::sourceChanged, this, [=] { emitDataChanged(index); });
+    connect(keyboardLayout, &DataIndexKeyboardLayout::isValidChanged, this, [=] { emitDataChanged(index); });
 }
 
 void ResourceModel::updateMappings()
@@ -43,7 +43,8 @@ public:
         KeyboardLayoutNameRole,
         PathRole,
         IndexRole,
-        SourceRole
+        SourceRole,
+        IsValidRole
     };
     Q_ENUM(AdditionalRoles)
     explicit ResourceModel( QObject* parent = nullptr);
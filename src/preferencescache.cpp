@@ -0,0 +1,71 @@
+/*
+ *  Copyright 2026  Sebastian Gottfried <sebastian.gottfried@posteo.de>
+ *
+ *  This program is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU General Public License as
+ *  published by the Free Software Foundation; either version 2 of
+ *  the License, or (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "preferencescache.h"
+
+#include <QCoreApplication>
+
+#include "preferences.h"
+
+PreferencesCache::PreferencesCache(QObject* parent):
+    QObject(parent),
+    m_snapshot(0)
+{
+    refresh();
+    connect(Preferences::self(), &KCoreConfigSkeleton::configChanged, this, &PreferencesCache::refresh);
+}
+
+PreferencesCache::~PreferencesCache()
+{
+    delete m_snapshot;
+}
+
+PreferencesCache* PreferencesCache::instance()
+{
+    static PreferencesCache* cache = new PreferencesCache(QCoreApplication::instance());
+    return cache;
+}
+
+const PreferencesSnapshot& PreferencesCache::snapshot()
+{
+    return *instance()->m_snapshot;
+}
+
+void PreferencesCache::refresh()
+{
+    PreferencesSnapshot* snapshot = new PreferencesSnapshot;
+    snapshot->enforceTypingErrorCorrection = Preferences::enforceTypingErrorCorrection();
+    snapshot->showKeyboard = Preferences::showKeyboard();
+    snapshot->showStatistics = Preferences::showStatistics();
+    snapshot->nextLineWithReturn = Preferences::nextLineWithReturn();
+    snapshot->nextLineWithSpace = Preferences::nextLineWithSpace();
+    snapshot->requiredStrokesPerMinute = Preferences::requiredStrokesPerMinute();
+    snapshot->requiredAccuracy = Preferences::requiredAccuracy();
+    snapshot->lastUsedProfileId = Preferences::lastUsedProfileId();
+    snapshot->sceneGraphLessonRenderer = Preferences::sceneGraphLessonRenderer();
+    snapshot->sceneGraphKeyboardRenderer = Preferences::sceneGraphKeyboardRenderer();
+
+    for (int i = 0; i < PreferencesSnapshot::fingerColorCount; i++)
+    {
+        snapshot->fingerColors[i] = Preferences::fingerColor(i);
+    }
+
+    delete m_snapshot;
+    m_snapshot = snapshot;
+
+    emit snapshotChanged();
+}
@@ -0,0 +1,69 @@
+/*
+ *  Copyright 2026  Sebastian Gottfried <sebastian.gottfried@posteo.de>
+ *
+ *  This program is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU General Public License as
+ *  published by the Free Software Foundation; either version 2 of
+ *  the License, or (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef PREFERENCESCACHE_H
+#define PREFERENCESCACHE_H
+
+#include <QObject>
+#include <QColor>
+
+struct PreferencesSnapshot
+{
+    static const int fingerColorCount = 8;
+
+    bool enforceTypingErrorCorrection;
+    bool showKeyboard;
+    bool showStatistics;
+    bool nextLineWithReturn;
+    bool nextLineWithSpace;
+    int requiredStrokesPerMinute;
+    double requiredAccuracy;
+    int lastUsedProfileId;
+    bool sceneGraphLessonRenderer;
+    bool sceneGraphKeyboardRenderer;
+    QColor fingerColors[fingerColorCount];
+};
+
+/**
+ * Holds an immutable copy of the preferences for code reading them on every
+ * key press. The copy is replaced as a whole whenever the configuration is
+ * saved, e.g. by the configuration dialog, or changed through refresh().
+ *
+ * The cache is meant for the GUI thread only, snapshots are replaced there
+ * and a replaced snapshot is deleted right away. Don't keep a reference to
+ * one across event loop iterations.
+ */
+class PreferencesCache : public QObject
+{
+    Q_OBJECT
+public:
+    static PreferencesCache* instance();
+    static const PreferencesSnapshot& snapshot();
+    ~PreferencesCache();
+
+public slots:
+    void refresh();
+
+signals:
+    void snapshotChanged();
+
+private:
+    explicit PreferencesCache(QObject* parent = 0);
+    const PreferencesSnapshot* m_snapshot;
+};
+
+#endif // PREFERENCESCACHE_H
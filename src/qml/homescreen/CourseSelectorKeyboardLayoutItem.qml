@@ -40,6 +40,25 @@ Column {
         }
     }
 
+    onSelectedCourseChanged: prefetchNeighbourCourses()
+
+    function prefetchNeighbourCourses() {
+        // parse the courses next to the selected one in the background,
+        // so flipping through the list doesn't have to wait for them
+        var count = courseModel.rowCount()
+        for (var i = 0; i < count; i++) {
+            if (courseModel.data(courseModel.index(i, 0), ResourceModel.DataRole) === root.selectedCourse) {
+                if (i > 0) {
+                    dataAccess.prefetchCourse(courseModel.data(courseModel.index(i - 1, 0), ResourceModel.DataRole))
+                }
+                if (i + 1 < count) {
+                    dataAccess.prefetchCourse(courseModel.data(courseModel.index(i + 1, 0), ResourceModel.DataRole))
+                }
+                return
+            }
+        }
+    }
+
     CategorizedResourceSortFilterProxyModel {
         id: courseModel
         resourceModel: root.resourceModel
@@ -113,7 +113,7 @@ FocusScope {
                     profile: profileComboBox.profile
                     currentKeyboardLayoutName: screen.activeKeyboardLayoutName
                     onSelectedKeyboardLayoutChanged: {
-                        dataAccess.loadKeyboardLayout(courseSelector.selectedKeyboardLayout, screen.selectedKeyboardLayout)
+                        dataAccess.loadKeyboardLayoutAsync(courseSelector.selectedKeyboardLayout, screen.selectedKeyboardLayout)
                     }
                 }
 
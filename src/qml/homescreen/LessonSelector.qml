@@ -65,6 +65,15 @@ FocusScope {
         root.update();
     }
 
+    Connections {
+        target: dataAccess
+        onCourseLoaded: {
+            if (course === courseItem) {
+                root.update()
+            }
+        }
+    }
+
     Course {
         id: courseItem
         property int lastUnlockedLessonIndex: -1
@@ -74,13 +83,14 @@ FocusScope {
                 return
             }
             if (dataIndexCourse.id == "custom_lessons") {
+                dataAccess.cancelLoad(courseItem)
                 profileDataAccess.loadCustomLessons(root.profile, dataIndexCourse.keyboardLayoutName, courseItem)
             }
             else {
                 if (isValid && courseItem.id === dataIndexCourse.id) {
                     return
                 }
-                dataAccess.loadCourse(dataIndexCourse, courseItem)
+                dataAccess.loadCourseAsync(dataIndexCourse, courseItem)
             }
         }
         function updateLastUnlockedLessonIndex() {
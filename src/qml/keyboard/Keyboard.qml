@@ -24,6 +24,9 @@ Item {
     signal keyboardUpdate
 
     property KeyboardLayout keyboardLayout
+    property LessonKeyMask keyMask: null
+    property KeyboardHighlightController highlightController: null
+    property bool sceneGraphRenderer: false
     property real aspectRatio: keyboardLayout.width / keyboardLayout.height
     property real horizontalScaleFactor: width / keyboardLayout.width
     property real verticalScaleFactor: height / keyboardLayout.height
@@ -38,40 +41,80 @@ Item {
         return items
     }
 
-    function findKeyItems(keyChar) {
+    function isKeyEnabled(keyIndex) {
+        if (!keyMask)
+            return true
+        var enabledKeys = keyMask.enabledKeys
+        return keyIndex < enabledKeys.length? enabledKeys[keyIndex]: true
+    }
+
+    function keyItem(keyIndex) {
+        return keys.itemAt(keyIndex)
+    }
+
+    function findKeyItems(data) {
+        var eventText = data
+        var eventKey = -1
+        if (typeof data === "object") {
+            eventText = data.text
+            eventKey = data.key
+        }
+        if (typeof data === "number") {
+            eventText = ""
+            eventKey = data
+        }
+
+        var keyIndexes = keyboardLayout.findKeyIndexes(eventText, eventKey)
         var matchingKeys = []
 
-        for (var i = 0; i < keys.count; i++) {
-            var key = keys.itemAt(i);
-            if (key.match(keyChar))
-            matchingKeys.push(key)
+        for (var i = 0; i < keyIndexes.length; i++) {
+            var key = keys.itemAt(keyIndexes[i])
+            if (key)
+                matchingKeys.push(key)
         }
 
         return matchingKeys
     }
 
     function findModifierKeyItem(modifierId) {
-        for (var i = 0; i < keys.count; i++) {
-            var key = keys.itemAt(i);
-            if (key.key.keyType() === "specialKey" && key.key.modifierId === modifierId)
-                return key
-        }
-        return null
+        var keyIndex = keyboardLayout.modifierKeyIndex(modifierId)
+        return keyIndex !== -1? keys.itemAt(keyIndex): null
     }
 
-    function handleKeyPress(event) {
+    function setKeysPressed(event, pressed) {
+        if (rendererLoader.item) {
+            var keyIndexes = keyboardLayout.findKeyIndexes(event.text, event.key)
+            for (var i = 0; i < keyIndexes.length; i++) {
+                rendererLoader.item.setKeyPressed(keyIndexes[i], pressed)
+            }
+            return
+        }
+
         var eventKeys = findKeyItems(event)
 
-        for (var i = 0; i < eventKeys.length; i++) {
-            eventKeys[i].pressed = true
+        for (var j = 0; j < eventKeys.length; j++) {
+            eventKeys[j].pressed = pressed
         }
     }
 
+    function handleKeyPress(event) {
+        setKeysPressed(event, true)
+    }
+
     function handleKeyRelease(event) {
-        var eventKeys = findKeyItems(event)
+        setKeysPressed(event, false)
+    }
+
+    Loader {
+        id: rendererLoader
+        anchors.fill: parent
+        active: keyboard.sceneGraphRenderer
 
-        for (var i = 0; i < eventKeys.length; i++) {
-            eventKeys[i].pressed = false
+        sourceComponent: KeyboardRenderer {
+            keyboardLayout: keyboard.keyboardLayout
+            keyMask: keyboard.keyMask
+            highlightController: keyboard.highlightController
+            visible: keyboard.visible
         }
     }
 
@@ -84,13 +127,14 @@ Item {
 
         Repeater {
             id: keys
-            model: keyboard.visible && keyboardLayout.isValid? keyboard.keyboardLayout.keyCount: 0
+            model: keyboard.visible && keyboardLayout.isValid && !keyboard.sceneGraphRenderer? keyboard.keyboardLayout.keyCount: 0
 
             onModelChanged: keyboard.keyboardUpdate()
 
             KeyItem {
                 keyboardLayout: keyboard.keyboardLayout;
                 keyIndex: index
+                enabled: keyboard.isKeyEnabled(index)
                 horizontalScaleFactor: keyboard.horizontalScaleFactor
                 verticalScaleFactor: keyboard.verticalScaleFactor
             }
@@ -17,6 +17,7 @@
 
 import QtQuick 2.9
 import QtQuick.Layouts 1.3
+import QtQuick.Window 2.2
 import ktouch 1.0
 
 import "../common"
@@ -43,48 +44,6 @@ FocusScope {
     property bool trainingFinished: true
     property bool isActive: Qt.application.active
 
-    function setLessonKeys() {
-        if (!lesson)
-            return;
-
-        var chars = lesson.characters;
-        var keyItems = keyboard.keyItems()
-        var modifierItems = []
-        var usedModifiers = {}
-
-        for (var i = 0; i < keyItems.length; i++) {
-            var key = keyItems[i].key
-            if (key.keyType() == "key") {
-                keyItems[i].enabled = false;
-                for (var j = 0; j < key.keyCharCount; j++) {
-                    var keyChar = key.keyChar(j)
-                    if (chars.indexOf(keyChar.value) != -1) {
-                        keyItems[i].enabled = true;
-                        if (keyChar.modifier !== "") {
-                            usedModifiers[keyChar.modifier] = true
-                        }
-                    }
-                }
-            }
-            else {
-                var type = keyItems[i].key.type
-                if (type != SpecialKey.Return && type != SpecialKey.Backspace && type != SpecialKey.Space)
-                {
-                    modifierItems.push(keyItems[i])
-                    keyItems[i].enabled = false
-                }
-                else if (type == SpecialKey.Return && preferences.nextLineWithSpace) {
-                    keyItems[i].enabled = false
-                }
-            }
-        }
-
-        for (i = 0; i < modifierItems.length; i++) {
-            var modifierItem = modifierItems[i]
-            modifierItem.enabled = !!usedModifiers[modifierItem.key.modifierId]
-        }
-    }
-
     function reset() {
         toolbar.reset()
         trainingWidget.reset()
@@ -103,8 +62,6 @@ FocusScope {
         trainingWidget.forceActiveFocus()
     }
 
-    onLessonChanged: setLessonKeys()
-
     onIsActiveChanged: {
         if (!screen.isActive) {
             stats.stopTraining()
@@ -119,6 +76,7 @@ FocusScope {
 
     TrainingStats {
         id: stats
+        window: screen.Window.window
         onTimeIsRunningChanged: {
             if (timeIsRunning) {
                 screen.trainingStarted = false
@@ -209,8 +167,6 @@ FocusScope {
                 overlayContainer: trainingOverlayContainer
                 onKeyPressed: keyboard.handleKeyPress(event)
                 onKeyReleased: keyboard.handleKeyRelease(event)
-                onNextCharChanged: keyboard.updateKeyHighlighting()
-                onIsCorrectChanged: keyboard.updateKeyHighlighting()
                 onFinished: {
                     profileDataAccess.saveTrainingStats(stats, screen.profile, screen.course.id, screen.lesson.id)
                     screen.finished(stats)
@@ -249,52 +205,10 @@ FocusScope {
             Keyboard {
                 id: keyboard
 
-                property variant highlightedKeys: []
-                function highlightKey(which) {
-                    for (var i = 0; i < highlightedKeys.length; i++)
-                        highlightedKeys[i].isHighlighted = false
-                    var keys = findKeyItems(which)
-                    var newHighlightedKeys = []
-                    for (var index = 0; index < keys.length ; index++) {
-                        var key = keys[index]
-                        if (key) {
-                            key.isHighlighted = true
-                            newHighlightedKeys.push(key)
-                            if (typeof which == "string") {
-                                for (var i = 0; i < key.key.keyCharCount; i++) {
-                                    var keyChar = key.key.keyChar(i)
-                                    if (keyChar.value == which && keyChar.modifier != "") {
-                                        var modifier = findModifierKeyItem(keyChar.modifier)
-                                        if (modifier) {
-                                            modifier.isHighlighted = true
-                                            newHighlightedKeys.push(modifier)
-                                        }
-                                        break
-                                    }
-                                }
-                            }
-                        }
-                    }
-                    highlightedKeys = newHighlightedKeys
-                }
-
-                function updateKeyHighlighting() {
-                    if (!visible)
-                        return;
-                    if (trainingWidget.isCorrect) {
-                        if (trainingWidget.nextChar !== "") {
-                            highlightKey(trainingWidget.nextChar)
-                        }
-                        else {
-                            highlightKey(preferences.nextLineWithSpace? Qt.Key_Space: Qt.Key_Return)
-                        }
-                    }
-                    else {
-                        highlightKey(Qt.Key_Backspace)
-                    }
-                }
-
                 keyboardLayout: screen.keyboardLayout
+                keyMask: lessonKeyMask
+                highlightController: highlightController
+                sceneGraphRenderer: preferences.sceneGraphKeyboardRenderer
                 anchors {
                     fill: parent
                     leftMargin: Units.gridUnit
@@ -304,9 +218,30 @@ FocusScope {
                 }
 
                 onKeyboardUpdate: {
-                    setLessonKeys()
-                    highlightedKeys = []
-                    updateKeyHighlighting()
+                    var highlightedKeys = highlightController.highlightedKeys()
+                    for (var i = 0; i < highlightedKeys.length; i++) {
+                        var key = keyItem(highlightedKeys[i])
+                        if (key)
+                            key.isHighlighted = true
+                    }
+                }
+            }
+
+            LessonKeyMask {
+                id: lessonKeyMask
+                keyboardLayout: screen.keyboardLayout
+                lesson: screen.lesson
+            }
+
+            KeyboardHighlightController {
+                id: highlightController
+                keyboardLayout: screen.keyboardLayout
+                trainingLineCore: trainingWidget.trainingLineCore
+                enabled: keyboard.visible
+                onKeyHighlightChanged: {
+                    var key = keyboard.keyItem(keyIndex)
+                    if (key)
+                        key.isHighlighted = highlighted
                 }
             }
 
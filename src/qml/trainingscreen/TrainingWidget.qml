@@ -31,7 +31,9 @@ FocusScope {
 
     property alias nextChar: trainingLine.nextCharacter
     property alias isCorrect: trainingLine.isCorrect
+    property alias trainingLineCore: trainingLine
     property int position: -1
+    property Item lessonPainter: lessonPainterLoader.item
     signal finished
     signal keyPressed(variant event)
     signal keyReleased(variant event)
@@ -99,25 +101,48 @@ FocusScope {
                 x: Units.gridUnit
                 y: Units.gridUnit
                 width: trainingWidget.width - 2 * Units.gridUnit
-                height: lessonPainter.height
+                height: lessonPainterLoader.height
 
                 border {
                     width: Units.borderWidth
                     color: "#000"
                 }
 
-                LessonPainter {
-                    id: lessonPainter
+                Loader {
+                    id: lessonPainterLoader
                     anchors.centerIn: sheet
-                    lesson: trainingWidget.lesson
-                    maximumWidth: parent.width
-                    trainingLineCore: trainingLine
+                    sourceComponent: preferences.sceneGraphLessonRenderer? lessonRendererComponent: lessonPainterComponent
+                }
 
+                Component {
+                    id: lessonPainterComponent
+                    LessonPainter {
+                        lesson: trainingWidget.lesson
+                        maximumWidth: sheet.width
+                        trainingLineCore: trainingLine
+                    }
+                }
+
+                Component {
+                    id: lessonRendererComponent
+                    LessonRenderer {
+                        lesson: trainingWidget.lesson
+                        maximumWidth: sheet.width
+                        trainingLineCore: trainingLine
+                    }
+                }
+
+                Connections {
+                    target: lessonPainter
                     onDone: {
                         trainingLine.active = false
                         trainingWidget.finished();
                         stats.stopTraining();
                     }
+                }
+
+                Item {
+                    anchors.fill: lessonPainterLoader
 
                     TrainingLineCore {
                         id: trainingLine
@@ -0,0 +1,147 @@
+/*
+ *  Copyright 2026  Sebastian Gottfried <sebastian.gottfried@posteo.de>
+ *
+ *  This program is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU General Public License as
+ *  published by the Free Software Foundation; either version 2 of
+ *  the License, or (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "startuptrace.h"
+
+#include <QCoreApplication>
+#include <QDebug>
+#include <QElapsedTimer>
+#include <QHash>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QSaveFile>
+#include <QStringList>
+#include <QThread>
+#include <QVector>
+
+namespace
+{
+    struct TraceEvent
+    {
+        QString name;
+        int threadId;
+        qint64 begin;
+        qint64 end;
+    };
+
+    struct TraceData
+    {
+        TraceData()
+        {
+            timer.start();
+        }
+
+        QElapsedTimer timer;
+        QMutex mutex;
+        QVector<TraceEvent> events;
+        QHash<QThread*, int> threadIds;
+        QStringList threadNames;
+    };
+
+    Q_GLOBAL_STATIC(TraceData, traceData)
+}
+
+StartupTrace::Span::Span(const QString& name):
+    m_name(name),
+    m_begin(StartupTrace::now())
+{
+}
+
+StartupTrace::Span::~Span()
+{
+    StartupTrace::record(m_name, m_begin, StartupTrace::now());
+}
+
+qint64 StartupTrace::now()
+{
+    return traceData()->timer.nsecsElapsed();
+}
+
+void StartupTrace::record(const QString& name, qint64 begin, qint64 end)
+{
+    TraceData* data = traceData();
+    QThread* const thread = QThread::currentThread();
+
+    QMutexLocker locker(&data->mutex);
+
+    int threadId = data->threadIds.value(thread, -1);
+
+    if (threadId == -1)
+    {
+        threadId = data->threadIds.count();
+        data->threadIds.insert(thread, threadId);
+        const bool isMainThread = QCoreApplication::instance() && thread == QCoreApplication::instance()->thread();
+        data->threadNames.append(isMainThread? QStringLiteral("main"): QStringLiteral("worker %1").arg(threadId));
+    }
+
+    data->events.append({name, threadId, begin, end});
+}
+
+bool StartupTrace::writeChromeTrace(const QString& path)
+{
+    TraceData* data = traceData();
+    const qint64 pid = QCoreApplication::applicationPid();
+    QJsonArray traceEvents;
+
+    {
+        QMutexLocker locker(&data->mutex);
+
+        for (int i = 0; i < data->threadNames.count(); i++)
+        {
+            QJsonObject threadNameEvent;
+            threadNameEvent.insert(QStringLiteral("name"), QStringLiteral("thread_name"));
+            threadNameEvent.insert(QStringLiteral("ph"), QStringLiteral("M"));
+            threadNameEvent.insert(QStringLiteral("pid"), pid);
+            threadNameEvent.insert(QStringLiteral("tid"), i);
+            threadNameEvent.insert(QStringLiteral("args"), QJsonObject {{QStringLiteral("name"), data->threadNames.at(i)}});
+            traceEvents.append(threadNameEvent);
+        }
+
+        foreach (const TraceEvent& event, data->events)
+        {
+            QJsonObject spanEvent;
+            spanEvent.insert(QStringLiteral("name"), event.name);
+            spanEvent.insert(QStringLiteral("cat"), QStringLiteral("startup"));
+            spanEvent.insert(QStringLiteral("ph"), QStringLiteral("X"));
+            spanEvent.insert(QStringLiteral("pid"), pid);
+            spanEvent.insert(QStringLiteral("tid"), event.threadId);
+            // the trace format expects microseconds
+            spanEvent.insert(QStringLiteral("ts"), event.begin / 1000.0);
+            spanEvent.insert(QStringLiteral("dur"), (event.end - event.begin) / 1000.0);
+            traceEvents.append(spanEvent);
+        }
+    }
+
+    QJsonObject root;
+    root.insert(QStringLiteral("traceEvents"), traceEvents);
+    root.insert(QStringLiteral("displayTimeUnit"), QStringLiteral("ms"));
+
+    QSaveFile file(path);
+
+    if (!file.open(QIODevice::WriteOnly))
+    {
+        qWarning() << "can't open:" << path;
+        return false;
+    }
+
+    file.write(QJsonDocument(root).toJson(QJsonDocument::Indented));
+
+    return file.commit();
+}
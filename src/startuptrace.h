@@ -0,0 +1,46 @@
+/*
+ *  Copyright 2026  Sebastian Gottfried <sebastian.gottfried@posteo.de>
+ *
+ *  This program is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU General Public License as
+ *  published by the Free Software Foundation; either version 2 of
+ *  the License, or (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef STARTUPTRACE_H
+#define STARTUPTRACE_H
+
+#include <QString>
+
+/**
+ * Collects timing spans of the startup stages. The spans can be recorded
+ * from any thread and are dumped in the Chrome trace event format, so they
+ * can be inspected with chrome://tracing or Perfetto.
+ */
+class StartupTrace
+{
+public:
+    class Span
+    {
+    public:
+        explicit Span(const QString& name);
+        ~Span();
+    private:
+        QString m_name;
+        qint64 m_begin;
+    };
+
+    static qint64 now();
+    static void record(const QString& name, qint64 begin, qint64 end);
+    static bool writeChromeTrace(const QString& path);
+};
+
+#endif // STARTUPTRACE_H
@@ -128,7 +128,15 @@ LayoutUnit X11Helper::getCurrentLayout()
     if (!QX11Info::isPlatformX11()) {
         return LayoutUnit();
     }
-    QList<LayoutUnit> currentLayouts = getLayoutsList();
+    return getCurrentLayout(getLayoutsList());
+}
+
+// only asks the server for the current group, for callers that keep the layout list around
+LayoutUnit X11Helper::getCurrentLayout(const QList<LayoutUnit>& currentLayouts)
+{
+    if (!QX11Info::isPlatformX11()) {
+        return LayoutUnit();
+    }
     unsigned int group = X11Helper::getGroup();
     if( group < (unsigned int)currentLayouts.size() )
         return currentLayouts[group];
@@ -240,6 +240,7 @@ public:
     static bool setDefaultLayout();
     static bool setLayout(const LayoutUnit& layout);
     static LayoutUnit getCurrentLayout();
+    static LayoutUnit getCurrentLayout(const QList<LayoutUnit>& layouts);
     static LayoutSet getCurrentLayouts();
     static QList<LayoutUnit> getLayoutsList();
     static QStringList getLayoutsListAsString(const QList<LayoutUnit>& layoutsList);